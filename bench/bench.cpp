@@ -0,0 +1,290 @@
+//
+// file: bench.cpp
+// author: Michael Brockus
+// gmail: <michaelbrockus@gmail.com>
+//
+// USE CASE:
+//
+// Micro-benchmarks for the game functions, from single calls on the empty
+// board and a mid-game board up to sweeps over every reachable position
+// and the batch and parallel entry points. Every benchmark reports time
+// per call, nodes per second where it searches and heap allocations per
+// call, written as JSON to stdout or to the file named by argv[1] so runs
+// of different builds can be compared.
+//
+#include "game.hpp"
+#include "mcts.hpp"
+#include "simd_kernel.hpp"
+#include "solved.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <string>
+#include <vector>
+
+const double MIN_BENCH_SECONDS = 0.25;
+
+//
+// Every heap allocation in the process goes through here so a benchmark
+// can tell how many its calls made
+//
+static std::atomic<std::uint64_t> allocationCount{0};
+
+void *operator new(std::size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void *memory = std::malloc(size == 0 ? 1 : size))
+    {
+        return memory;
+    } // end if
+    throw std::bad_alloc();
+} // end of function operator new
+
+void operator delete(void *memory) noexcept
+{
+    std::free(memory);
+} // end of function operator delete
+
+void operator delete(void *memory, std::size_t) noexcept
+{
+    std::free(memory);
+} // end of function operator delete
+
+//
+// Keep the compiler from dropping a result nobody reads
+//
+template <typename T>
+static void keep(const T &value)
+{
+    asm volatile("" : : "g"(&value) : "memory");
+} // end of function keep
+
+//
+// What one run of a benchmark body did
+//
+struct Work
+{
+    std::uint64_t calls = 1;
+    std::uint64_t nodes = 0;
+};
+
+struct BenchResult
+{
+    std::string name;
+    double nsPerCall = 0.0;
+    double nodesPerSecond = 0.0;
+    double allocationsPerCall = 0.0;
+    std::uint64_t calls = 0;
+};
+
+//
+// Run body until MIN_BENCH_SECONDS have passed, after one warm up run
+//
+static BenchResult runBench(const std::string &name, const std::function<Work()> &body)
+{
+    body();
+    BenchResult result;
+    result.name = name;
+    std::uint64_t nodes = 0;
+    std::uint64_t allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    double seconds = 0.0;
+    do
+    {
+        Work work = body();
+        result.calls += work.calls;
+        nodes += work.nodes;
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    } while (seconds < MIN_BENCH_SECONDS);
+
+    std::uint64_t allocations = allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+    result.nsPerCall = seconds * 1e9 / result.calls;
+    result.nodesPerSecond = nodes / seconds;
+    result.allocationsPerCall = static_cast<double>(allocations) / result.calls;
+    std::fprintf(stderr, "%-36s %12.1f ns/call %14.0f nodes/s %8.2f allocs/call\n", name.c_str(),
+                 result.nsPerCall, result.nodesPerSecond, result.allocationsPerCall);
+    return result;
+} // end of function runBench
+
+static Grid toGrid(Board board)
+{
+    Grid grid;
+    for (int cell = 0; cell < BOARD_CELLS; ++cell)
+    {
+        char marker = EMPTY_SPACE;
+        if (board.x & cellMask(cell))
+        {
+            marker = PLAYER_MARKER;
+        } // end if
+        else if (board.o & cellMask(cell))
+        {
+            marker = AI_MARKER;
+        } // end else if
+        grid[cell / Board::COLS][cell % Board::COLS] = marker;
+    } // end for
+    return grid;
+} // end of function toGrid
+
+//
+// Every position that can come up in a game, walked through the base 3 key
+//
+static std::vector<Board> reachableBoards()
+{
+    std::vector<Board> boards;
+    for (std::uint32_t key = 0; key < POSITION_COUNT; ++key)
+    {
+        if (!lookupSolved(key).reachable)
+        {
+            continue;
+        } // end if
+
+        Board board;
+        std::uint32_t digits = key;
+        for (int cell = 0; cell < BOARD_CELLS; ++cell, digits /= 3)
+        {
+            if (digits % 3 == 1)
+            {
+                board.x |= cellMask(cell);
+            } // end if
+            else if (digits % 3 == 2)
+            {
+                board.o |= cellMask(cell);
+            } // end else if
+        } // end for
+        boards.push_back(board);
+    } // end for
+    return boards;
+} // end of function reachableBoards
+
+static void writeJson(std::FILE *out, const std::vector<BenchResult> &results, unsigned threads)
+{
+    std::fprintf(out, "{\n  \"simd\": \"%s\",\n  \"threads\": %u,\n  \"benchmarks\": [\n",
+                 simdLevelName(detectSimdLevel()), threads);
+    for (std::size_t index = 0; index < results.size(); ++index)
+    {
+        const BenchResult &result = results[index];
+        std::fprintf(out,
+                     "    {\"name\": \"%s\", \"calls\": %llu, \"ns_per_call\": %.3f, "
+                     "\"nodes_per_second\": %.1f, \"allocations_per_call\": %.4f}%s\n",
+                     result.name.c_str(), static_cast<unsigned long long>(result.calls), result.nsPerCall,
+                     result.nodesPerSecond, result.allocationsPerCall, index + 1 < results.size() ? "," : "");
+    } // end for
+    std::fprintf(out, "  ]\n}\n");
+} // end of function writeJson
+
+int main(int argc, char **argv)
+{
+    const Grid emptyGrid = toGrid(Board{});
+    const Grid midGrid = {{{PLAYER_MARKER, EMPTY_SPACE, AI_MARKER},
+                           {EMPTY_SPACE, PLAYER_MARKER, EMPTY_SPACE},
+                           {EMPTY_SPACE, EMPTY_SPACE, AI_MARKER}}};
+    const std::vector<std::pair<int, int>> midPositions = getOccupiedPositions(midGrid, PLAYER_MARKER);
+    const std::vector<Board> boards = reachableBoards();
+    std::vector<Grid> grids;
+    std::vector<std::uint16_t> xs;
+    std::vector<std::uint16_t> os;
+    for (Board board : boards)
+    {
+        grids.push_back(toGrid(board));
+        xs.push_back(board.x);
+        os.push_back(board.o);
+    } // end for
+
+    ThreadPool pool;
+    std::vector<BenchResult> results;
+
+    results.push_back(runBench("getBoardState/empty", [&]
+                               { keep(getBoardState(emptyGrid, PLAYER_MARKER)); return Work{}; }));
+    results.push_back(runBench("getBoardState/midgame", [&]
+                               { keep(getBoardState(midGrid, AI_MARKER)); return Work{}; }));
+    results.push_back(runBench("getLegalMoves/empty", [&]
+                               { keep(getLegalMoves(emptyGrid)); return Work{}; }));
+    results.push_back(runBench("getLegalMoves/midgame", [&]
+                               { keep(getLegalMoves(midGrid)); return Work{}; }));
+    results.push_back(runBench("gameIsWon/midgame", [&]
+                               { keep(gameIsWon(midPositions)); return Work{}; }));
+    results.push_back(runBench("findBestMove/empty", [&]
+                               { keep(findBestMove(emptyGrid)); return Work{}; }));
+    results.push_back(runBench("findBestMove/midgame", [&]
+                               { keep(findBestMove(midGrid)); return Work{}; }));
+    results.push_back(runBench("findBestMove/reachable", [&]
+                               {
+        for (const Grid &grid : grids)
+        {
+            keep(findBestMove(grid));
+        } // end for
+        return Work{grids.size(), 0}; }));
+    results.push_back(runBench("getBoardState/reachable", [&]
+                               {
+        for (const Grid &grid : grids)
+        {
+            keep(getBoardState(grid, PLAYER_MARKER));
+        } // end for
+        return Work{grids.size(), 0}; }));
+
+    std::vector<std::pair<int, int>> moves(grids.size());
+    results.push_back(runBench("findBestMoves/reachable", [&]
+                               {
+        findBestMoves(grids, moves);
+        keep(moves);
+        return Work{grids.size(), 0}; }));
+
+    std::vector<Outcome> outcomes(boards.size());
+    results.push_back(runBench("classifyBoards/reachable", [&]
+                               {
+        classifyBoards<Board>(xs, os, outcomes);
+        keep(outcomes);
+        return Work{boards.size(), 0}; }));
+
+    results.push_back(runBench("minimaxSearch/empty", [&]
+                               {
+        SearchResult result = minimaxSearch(Board{});
+        return Work{1, result.nodes}; }));
+
+    TranspositionTable table(POSITION_COUNT);
+    results.push_back(runBench("alphaBetaSearch/empty", [&]
+                               {
+        table.clear();
+        SearchResult result = alphaBetaSearch(Board{}, table);
+        return Work{1, result.nodes}; }));
+
+    SearchLimits depthSix;
+    depthSix.maxDepth = 6;
+    TranspositionTable largeTable(LARGE_TABLE_ENTRIES);
+    results.push_back(runBench("iterativeDeepening/4x4-depth6", [&]
+                               {
+        largeTable.clear();
+        SearchResult result = iterativeDeepeningSearch(Board4x4{}, depthSix, largeTable);
+        return Work{1, result.nodes}; }));
+    results.push_back(runBench("parallelSearch/4x4-depth6", [&]
+                               {
+        largeTable.clear();
+        SearchResult result = parallelSearch(Board4x4{}, depthSix, largeTable, pool);
+        return Work{1, result.nodes}; }));
+
+    //
+    // Tree search nodes per second are playouts per second
+    MctsLimits playouts;
+    playouts.maxPlayouts = 20000;
+    MctsTree tree(MCTS_TREE_NODES);
+    results.push_back(runBench("monteCarloSearch/7x7-serial", [&]
+                               {
+        MctsResult result = monteCarloSearch(Position<Board7x7>(), playouts, tree, nullptr);
+        return Work{1, result.playouts}; }));
+    results.push_back(runBench("monteCarloSearch/7x7-parallel", [&]
+                               {
+        MctsResult result = monteCarloSearch(Position<Board7x7>(), playouts, tree, &pool);
+        return Work{1, result.playouts}; }));
+
+    std::FILE *out = argc > 1 ? std::fopen(argv[1], "w") : stdout;
+    if (out == nullptr)
+    {
+        std::perror(argv[1]);
+        return EXIT_FAILURE;
+    } // end if
+    writeJson(out, results, pool.threadCount());
+    return out == stdout || std::fclose(out) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+} // end of function main
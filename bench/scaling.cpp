@@ -0,0 +1,59 @@
+//
+// file: scaling.cpp
+// author: Michael Brockus
+// gmail: <michaelbrockus@gmail.com>
+//
+// USE CASE:
+//
+// Measure how the parallel search scales with the number of threads.
+// The same fixed depth search runs with 1, 2, 4, ... threads up to every
+// hardware thread, each time on a fresh table, and the wall time, node
+// rate and speedup over one thread are printed as a table.
+//
+#include "search.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+const int SCALING_DEPTH = 9;
+
+int main(int argc, char **argv)
+{
+    int depth = argc > 1 ? std::atoi(argv[1]) : SCALING_DEPTH;
+    unsigned maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<unsigned> threadCounts;
+    for (unsigned threads = 1; threads < maxThreads; threads *= 2)
+    {
+        threadCounts.push_back(threads);
+    } // end for
+    threadCounts.push_back(maxThreads);
+
+    SearchLimits limits;
+    limits.maxDepth = depth;
+    Board5x5 board = playMove(Board5x5{}, Board5x5::cellIndex(2, 2), true);
+
+    std::printf("5x5 k=4, depth %d\n", depth);
+    std::printf("%8s %12s %14s %12s %8s\n", "threads", "ms", "nodes", "knodes/s", "speedup");
+    double singleMs = 0.0;
+    for (unsigned threads : threadCounts)
+    {
+        ThreadPool pool(threads);
+        TranspositionTable table(LARGE_TABLE_ENTRIES);
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        SearchResult result = parallelSearch(board, limits, table, pool);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (threads == 1)
+        {
+            singleMs = ms;
+        } // end if
+
+        std::printf("%8u %12.2f %14llu %12.1f %8.2f\n", threads, ms,
+                    static_cast<unsigned long long>(result.nodes),
+                    result.nodes / ms, singleMs / ms);
+    } // end for
+
+    return EXIT_SUCCESS;
+} // end of function main
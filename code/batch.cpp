@@ -0,0 +1,168 @@
+//
+// file: batch.cpp
+// author: Michael Brockus
+// gmail: <michaelbrockus@gmail.com>
+//
+#include "batch.hpp"
+#include "game.hpp"
+#include "solved.hpp"
+#include "stats.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <optional>
+#include <vector>
+
+//
+// Board described by one input line, nothing if it is not a position
+// that can come up in a game
+//
+static std::optional<Board> parseLine(std::string_view line)
+{
+    if (!line.empty() && line.back() == '\r')
+    {
+        line.remove_suffix(1);
+    } // end if
+
+    Board board;
+    if (line.size() == BOARD_CELLS && line.find_first_not_of("XOxo-") == std::string_view::npos)
+    {
+        for (int cell = 0; cell < BOARD_CELLS; ++cell)
+        {
+            if (line[cell] == 'X' || line[cell] == 'x')
+            {
+                board.x |= cellMask(cell);
+            } // end if
+            else if (line[cell] == 'O' || line[cell] == 'o')
+            {
+                board.o |= cellMask(cell);
+            } // end else if
+        } // end for
+    } // end if
+    else
+    {
+        for (char digit : line)
+        {
+            int cell = digit - '0';
+            if (cell < 0 || cell >= BOARD_CELLS || (occupiedCells(board) & cellMask(cell)) != 0 ||
+                hasWinningLine(board.x) || hasWinningLine(board.o))
+            {
+                return std::nullopt;
+            } // end if
+            board = playMove(board, cell, xToMove(board));
+        } // end for
+    } // end else
+
+    //
+    // Only the solved table knows if the mark counts and wins add up
+    if (!lookupSolved(board).reachable)
+    {
+        return std::nullopt;
+    } // end if
+    return board;
+} // end of function parseLine
+
+void analyzeLine(std::string_view line, std::string &output)
+{
+    std::optional<Board> board = parseLine(line);
+    if (!board)
+    {
+        output += "error\n";
+        return;
+    } // end if
+
+    SolvedEntry entry = lookupSolved(*board);
+    output += std::to_string(entry.move);
+    output += ' ';
+    output += std::to_string(entry.score);
+    output += ' ';
+    output += gameStateName(*board);
+    output += '\n';
+} // end of function analyzeLine
+
+//
+// Answer every line of text into output, the last may lack its newline.
+// Returns the number of lines answered.
+//
+static std::size_t analyzeSlice(std::string_view text, std::string &output)
+{
+    std::size_t lines = 0;
+    std::size_t start = 0;
+    while (start < text.size())
+    {
+        std::size_t end = text.find('\n', start);
+        if (end == std::string_view::npos)
+        {
+            end = text.size();
+        } // end if
+        analyzeLine(text.substr(start, end - start), output);
+        start = end + 1;
+        ++lines;
+    } // end while
+
+    return lines;
+} // end of function analyzeSlice
+
+//
+// Slices are answered into their own buffers, which are written out in
+// order once the whole chunk is done, so nothing is flushed per line
+//
+int runBatch(std::FILE *input, std::FILE *output, ThreadPool &pool)
+{
+    std::size_t sliceCount = pool.threadCount() * 4;
+    std::vector<std::string> answers(sliceCount);
+    std::vector<std::size_t> sliceStarts(sliceCount + 1);
+    std::string chunk;
+    bool finished = false;
+    while (!finished)
+    {
+        std::size_t kept = chunk.size();
+        chunk.resize(kept + BATCH_CHUNK_BYTES);
+        std::size_t got = std::fread(chunk.data() + kept, 1, BATCH_CHUNK_BYTES, input);
+        chunk.resize(kept + got);
+        finished = got < BATCH_CHUNK_BYTES;
+
+        //
+        // A line cut off by the end of the read waits for the next chunk
+        std::size_t usable = chunk.size();
+        if (!finished)
+        {
+            std::size_t lastNewline = chunk.rfind('\n');
+            usable = lastNewline == std::string::npos ? 0 : lastNewline + 1;
+        } // end if
+
+        //
+        // Cut the usable part into slices that start on a line
+        std::string_view text(chunk.data(), usable);
+        sliceStarts[0] = 0;
+        for (std::size_t slice = 1; slice < sliceCount; ++slice)
+        {
+            std::size_t start = std::max(sliceStarts[slice - 1], usable * slice / sliceCount);
+            if (start > 0)
+            {
+                std::size_t newline = text.find('\n', start - 1);
+                start = newline == std::string_view::npos ? usable : newline + 1;
+            } // end if
+            sliceStarts[slice] = start;
+        } // end for
+        sliceStarts[sliceCount] = usable;
+
+        pool.parallelFor(sliceCount, [&](std::size_t slice)
+                         {
+            TTD_STAT(std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now());
+            answers[slice].clear();
+            [[maybe_unused]] std::size_t lines =
+                analyzeSlice(text.substr(sliceStarts[slice], sliceStarts[slice + 1] - sliceStarts[slice]), answers[slice]);
+            TTD_STAT(recordLookups(lines, nanosSince(start))); });
+
+        for (const std::string &answer : answers)
+        {
+            if (std::fwrite(answer.data(), 1, answer.size(), output) != answer.size())
+            {
+                return EXIT_FAILURE;
+            } // end if
+        } // end for
+        chunk.erase(0, usable);
+    } // end while
+
+    return std::ferror(input) || std::fflush(output) != 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+} // end of function runBatch
@@ -0,0 +1,38 @@
+//
+// file: batch.hpp
+// author: Michael Brockus
+// gmail: <michaelbrockus@gmail.com>
+//
+#ifndef BATCH_HPP
+#define BATCH_HPP
+
+#include "thread_pool.hpp"
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+const std::size_t BATCH_CHUNK_BYTES = 1 << 22;
+
+//
+// Non-interactive analysis of logged games. Every input line is either a
+// board of nine X, O or - characters in row order, or a move sequence of
+// cell digits 0 to 8 starting with X, an empty line being the empty
+// board. Every output line is
+//
+//     <best move> <score> <state>
+//
+// with the cell the side to move should play (-1 when the game is over),
+// the solved score for the side to move, 1000 less the plies to a win or
+// -1000 plus the plies to a loss, and the state of the given board
+// (playing, x-wins, o-wins or draw). Lines that are not a legal position
+// answer "error".
+//
+void analyzeLine(std::string_view line, std::string &output);
+
+//
+// Stream input to output in chunks of BATCH_CHUNK_BYTES, analyzing the
+// lines of each chunk in parallel and writing the answers in input order.
+//
+int runBatch(std::FILE *input, std::FILE *output, ThreadPool &pool);
+
+#endif // end of BATCH_HPP
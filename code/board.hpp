@@ -0,0 +1,357 @@
+//
+// file: board.hpp
+// author: Michael Brockus
+// gmail: <michaelbrockus@gmail.com>
+//
+#ifndef BOARD_HPP
+#define BOARD_HPP
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <type_traits>
+
+enum class State
+{
+    WIN = 1000,
+    DRAW = 0,
+    LOSS = -1000
+};
+
+const int NO_MOVE = -1;
+
+//
+// Searched scores of won and lost positions count the plies to the end
+// of the game, a win in 3 scores WIN - 3 and a loss in 3 LOSS + 3, so
+// the quickest win and the slowest loss come out on top. Positions that
+// are neither won nor lost score strictly inside HEURISTIC_LIMIT.
+const int HEURISTIC_LIMIT = static_cast<int>(State::WIN) / 2;
+
+constexpr bool isDecided(int score)
+{
+    return score >= HEURISTIC_LIMIT || score <= -HEURISTIC_LIMIT;
+} // end of function isDecided
+
+//
+// Score of a position given the score of the position after its move,
+// negated and one ply further from the end when the game is decided
+//
+constexpr int scoreBeforeMove(int scoreAfter)
+{
+    if (scoreAfter >= HEURISTIC_LIMIT)
+    {
+        return -scoreAfter + 1;
+    } // end if
+    else if (scoreAfter <= -HEURISTIC_LIMIT)
+    {
+        return -scoreAfter - 1;
+    } // end else if
+
+    return -scoreAfter;
+} // end of function scoreBeforeMove
+
+//
+// Smallest unsigned type with one bit per cell
+template <int Cells>
+using MaskFor = std::conditional_t<(Cells <= 16), std::uint16_t,
+                                   std::conditional_t<(Cells <= 32), std::uint32_t, std::uint64_t>>;
+
+//
+// Number of K in a row lines on a Rows x Cols board
+//
+constexpr int winLineCount(int rows, int cols, int k)
+{
+    int rowStarts = rows - k + 1 > 0 ? rows - k + 1 : 0;
+    int colStarts = cols - k + 1 > 0 ? cols - k + 1 : 0;
+    return rows * colStarts + cols * rowStarts + 2 * rowStarts * colStarts;
+} // end of function winLineCount
+
+//
+// Every winning line as a cell mask: rows, then columns, then both diagonals
+//
+template <typename Mask, int Rows, int Cols, int K>
+constexpr std::array<Mask, winLineCount(Rows, Cols, K)> makeWinLines()
+{
+    std::array<Mask, winLineCount(Rows, Cols, K)> lines{};
+    const int directions[4][2] = {{0, 1}, {1, 0}, {1, 1}, {-1, 1}};
+    int count = 0;
+    for (const auto &direction : directions)
+    {
+        for (int row = 0; row < Rows; ++row)
+        {
+            for (int col = 0; col < Cols; ++col)
+            {
+                int lastRow = row + direction[0] * (K - 1);
+                int lastCol = col + direction[1] * (K - 1);
+                if (lastRow < 0 || lastRow >= Rows || lastCol >= Cols)
+                {
+                    continue;
+                } // end if
+
+                Mask line = 0;
+                for (int step = 0; step < K; ++step)
+                {
+                    int cell = (row + direction[0] * step) * Cols + (col + direction[1] * step);
+                    line |= static_cast<Mask>(Mask(1) << cell);
+                } // end for
+                lines[count++] = line;
+            } // end for
+
+        } // end for
+
+    } // end for
+
+    return lines;
+} // end of function makeWinLines
+
+//
+// Cells sorted by how many winning lines run through them, ties going to
+// the cell closest to the center. On 3x3 this is center, corners, edges.
+//
+template <typename Mask, int Rows, int Cols, int K>
+constexpr std::array<int, Rows * Cols> makeMoveOrder()
+{
+    constexpr std::array<Mask, winLineCount(Rows, Cols, K)> lines = makeWinLines<Mask, Rows, Cols, K>();
+    std::array<int, Rows * Cols> order{};
+    std::array<int, Rows * Cols> weight{};
+    for (int cell = 0; cell < Rows * Cols; ++cell)
+    {
+        int rowDistance = 2 * (cell / Cols) - (Rows - 1);
+        int colDistance = 2 * (cell % Cols) - (Cols - 1);
+        int lineCount = 0;
+        for (Mask line : lines)
+        {
+            lineCount += (line >> cell) & 1;
+        } // end for
+        order[cell] = cell;
+        weight[cell] = lineCount * 1024 - rowDistance * rowDistance - colDistance * colDistance;
+    } // end for
+
+    //
+    // Insertion sort keeps equal cells in row major order
+    for (int index = 1; index < Rows * Cols; ++index)
+    {
+        for (int back = index; back > 0 && weight[order[back]] > weight[order[back - 1]]; --back)
+        {
+            int cell = order[back];
+            order[back] = order[back - 1];
+            order[back - 1] = cell;
+        } // end for
+
+    } // end for
+
+    return order;
+} // end of function makeMoveOrder
+
+//
+// A Rows x Cols board where K in a row wins, made of two occupancy
+// masks. A cell is addressed as row * Cols + col and owns one bit of a
+// Mask. X always moves first.
+//
+template <int Rows, int Cols, int K>
+struct GameBoard
+{
+    static_assert(Rows > 0 && Cols > 0 && Rows * Cols <= 64, "a board has to fit in a 64 bit mask");
+    static_assert(K > 0 && winLineCount(Rows, Cols, K) > 0, "a winning line has to fit on the board");
+
+    using Mask = MaskFor<Rows * Cols>;
+
+    static constexpr int ROWS = Rows;
+    static constexpr int COLS = Cols;
+    static constexpr int IN_A_ROW = K;
+    static constexpr int CELLS = Rows * Cols;
+    static constexpr int LINE_COUNT = winLineCount(Rows, Cols, K);
+    static constexpr Mask FULL = static_cast<Mask>(CELLS == 64 ? ~0ull : (1ull << CELLS) - 1);
+    static constexpr std::array<Mask, LINE_COUNT> LINES = makeWinLines<Mask, Rows, Cols, K>();
+    static constexpr std::array<int, CELLS> MOVE_ORDER = makeMoveOrder<Mask, Rows, Cols, K>();
+
+    Mask x = 0;
+    Mask o = 0;
+
+    static constexpr int cellIndex(int row, int col)
+    {
+        return row * Cols + col;
+    } // end of function cellIndex
+
+    static constexpr Mask cellMask(int cell)
+    {
+        return static_cast<Mask>(Mask(1) << cell);
+    } // end of function cellMask
+
+    //
+    // Check if the given cells complete any winning line
+    //
+    static constexpr bool hasWinningLine(Mask cells)
+    {
+        for (Mask line : LINES)
+        {
+            if ((cells & line) == line)
+            {
+                return true;
+            } // end if
+
+        } // end for
+
+        return false;
+    } // end of function hasWinningLine
+};
+
+using Board = GameBoard<3, 3, 3>;
+using Board4x4 = GameBoard<4, 4, 4>;
+using Board5x5 = GameBoard<5, 5, 4>;
+using Board7x7 = GameBoard<7, 7, 5>;
+
+//
+// The classic game keeps its short names
+using Mask = Board::Mask;
+
+const int BOARD_CELLS = Board::CELLS;
+const Mask FULL_BOARD = Board::FULL;
+inline constexpr const std::array<Mask, Board::LINE_COUNT> &WIN_MASKS = Board::LINES;
+
+constexpr int cellIndex(int row, int col)
+{
+    return Board::cellIndex(row, col);
+} // end of function cellIndex
+
+constexpr Mask cellMask(int cell)
+{
+    return Board::cellMask(cell);
+} // end of function cellMask
+
+constexpr bool hasWinningLine(Mask cells)
+{
+    return Board::hasWinningLine(cells);
+} // end of function hasWinningLine
+
+template <typename B>
+constexpr typename B::Mask occupiedCells(B board)
+{
+    return board.x | board.o;
+} // end of function occupiedCells
+
+template <typename B>
+constexpr typename B::Mask legalMoveMask(B board)
+{
+    return B::FULL & ~occupiedCells(board);
+} // end of function legalMoveMask
+
+template <typename B>
+constexpr bool boardFull(B board)
+{
+    return occupiedCells(board) == B::FULL;
+} // end of function boardFull
+
+//
+// An even number of marks on the board means it is X's turn.
+//
+template <typename B>
+constexpr bool xToMove(B board)
+{
+    return (std::popcount(occupiedCells(board)) & 1) == 0;
+} // end of function xToMove
+
+template <typename B>
+constexpr B playMove(B board, int cell, bool forX)
+{
+    if (forX)
+    {
+        board.x |= B::cellMask(cell);
+    } // end if
+    else
+    {
+        board.o |= B::cellMask(cell);
+    } // end else
+
+    return board;
+} // end of function playMove
+
+//
+// Score the board from the point of view of X or O
+//
+template <typename B>
+constexpr int boardState(B board, bool forX)
+{
+    if (B::hasWinningLine(forX ? board.x : board.o))
+    {
+        return static_cast<int>(State::WIN);
+    } // end if
+
+    if (B::hasWinningLine(forX ? board.o : board.x))
+    {
+        return static_cast<int>(State::LOSS);
+    } // end if
+
+    return static_cast<int>(State::DRAW);
+} // end of function boardState
+
+//
+// Base 3 value of every cell mask, each cell is worth 3^cell
+constexpr std::array<std::uint16_t, FULL_BOARD + 1> TERNARY_WEIGHTS = []
+{
+    std::array<std::uint16_t, FULL_BOARD + 1> weights{};
+    for (int cells = 0; cells <= FULL_BOARD; ++cells)
+    {
+        int weight = 0;
+        for (int cell = BOARD_CELLS - 1; cell >= 0; --cell)
+        {
+            weight = weight * 3 + ((cells >> cell) & 1);
+        } // end for
+        weights[cells] = static_cast<std::uint16_t>(weight);
+    } // end for
+
+    return weights;
+}();
+
+const std::uint32_t POSITION_COUNT = 19683;
+
+//
+// Compact position key, the base 3 number where each cell is 0 (empty), 1 (X) or 2 (O)
+//
+constexpr std::uint32_t positionKey(Board board)
+{
+    return TERNARY_WEIGHTS[board.x] + 2u * TERNARY_WEIGHTS[board.o];
+} // end of function positionKey
+
+//
+// Random 64 bit keys for every (side, cell), boards too big for a base 3
+// key are hashed by XOR-ing the keys of their marks together.
+constexpr std::array<std::array<std::uint64_t, 64>, 2> ZOBRIST_KEYS = []
+{
+    std::array<std::array<std::uint64_t, 64>, 2> keys{};
+    std::uint64_t state = 0x9E3779B97F4A7C15ull;
+    for (auto &side : keys)
+    {
+        for (std::uint64_t &key : side)
+        {
+            //
+            // splitmix64
+            state += 0x9E3779B97F4A7C15ull;
+            std::uint64_t mixed = state;
+            mixed = (mixed ^ (mixed >> 30)) * 0xBF58476D1CE4E5B9ull;
+            mixed = (mixed ^ (mixed >> 27)) * 0x94D049BB133111EBull;
+            key = mixed ^ (mixed >> 31);
+        } // end for
+
+    } // end for
+
+    return keys;
+}();
+
+template <typename B>
+constexpr std::uint64_t zobristKey(B board)
+{
+    std::uint64_t key = 0;
+    for (typename B::Mask cells = board.x; cells != 0; cells &= cells - 1)
+    {
+        key ^= ZOBRIST_KEYS[0][std::countr_zero(cells)];
+    } // end for
+    for (typename B::Mask cells = board.o; cells != 0; cells &= cells - 1)
+    {
+        key ^= ZOBRIST_KEYS[1][std::countr_zero(cells)];
+    } // end for
+
+    return key;
+} // end of function zobristKey
+
+#endif // end of BOARD_HPP
@@ -0,0 +1,219 @@
+//
+// file: book.cpp
+// author: Michael Brockus
+// gmail: <michaelbrockus@gmail.com>
+//
+#include "book.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define TTD_HAVE_MMAP 1
+#endif
+
+OpeningBook::~OpeningBook()
+{
+    close();
+} // end of destructor
+
+//
+// Map a book made for the given board size, false if the file is missing,
+// from another version or for another board
+//
+bool OpeningBook::open(const std::string &path, int rows, int cols, int inARow)
+{
+    close();
+#if defined(TTD_HAVE_MMAP)
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return false;
+    } // end if
+
+    struct stat info;
+    void *mapped = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && static_cast<std::size_t>(info.st_size) >= sizeof(BookHeader))
+    {
+        mapped = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    } // end if
+    ::close(fd);
+    if (mapped == MAP_FAILED)
+    {
+        return false;
+    } // end if
+
+    mapping = mapped;
+    mappedBytes = static_cast<std::size_t>(info.st_size);
+    const BookHeader &header = *static_cast<const BookHeader *>(mapping);
+    if (std::memcmp(header.magic, BOOK_MAGIC, sizeof(BOOK_MAGIC)) != 0 || header.version != BOOK_VERSION ||
+        header.byteOrder != BOOK_BYTE_ORDER || header.rows != rows || header.cols != cols ||
+        header.inARow != inARow || header.count > (mappedBytes - sizeof(BookHeader)) / BOOK_ENTRY_BYTES ||
+        mappedBytes != sizeof(BookHeader) + header.count * BOOK_ENTRY_BYTES)
+    {
+        close();
+        return false;
+    } // end if
+
+    count = static_cast<std::size_t>(header.count);
+    keys = reinterpret_cast<const std::uint64_t *>(static_cast<const char *>(mapping) + sizeof(BookHeader));
+    values = reinterpret_cast<const std::uint32_t *>(keys + count);
+    return true;
+#else
+    (void)path;
+    (void)rows;
+    (void)cols;
+    (void)inARow;
+    return false;
+#endif
+} // end of function open
+
+void OpeningBook::close()
+{
+#if defined(TTD_HAVE_MMAP)
+    if (mapping != nullptr)
+    {
+        munmap(mapping, mappedBytes);
+    } // end if
+#endif
+    mapping = nullptr;
+    mappedBytes = 0;
+    keys = nullptr;
+    values = nullptr;
+    count = 0;
+} // end of function close
+
+bool OpeningBook::isOpen() const
+{
+    return mapping != nullptr;
+} // end of function isOpen
+
+std::size_t OpeningBook::size() const
+{
+    return count;
+} // end of function size
+
+//
+// Binary search straight on the mapped keys
+//
+bool OpeningBook::find(std::uint64_t key, std::uint32_t &value) const
+{
+    const std::uint64_t *found = std::lower_bound(keys, keys + count, key);
+    if (found == keys + count || *found != key)
+    {
+        return false;
+    } // end if
+
+    value = values[found - keys];
+    return true;
+} // end of function find
+
+template <typename B>
+bool writeOpeningBook(const std::string &path, std::span<const B> boards, std::span<const SearchResult> results)
+{
+    std::vector<std::pair<std::uint64_t, std::uint32_t>> entries;
+    std::size_t boardCount = std::min(boards.size(), results.size());
+    for (std::size_t index = 0; index < boardCount; ++index)
+    {
+        int symmetry;
+        std::uint64_t key = bookKey(boards[index], symmetry);
+        int move = results[index].move;
+        if constexpr (std::is_same_v<B, Board>)
+        {
+            move = moveToCanonical(move, symmetry);
+        } // end if
+
+        std::uint32_t value = static_cast<std::uint16_t>(results[index].score) |
+                              static_cast<std::uint32_t>(static_cast<std::uint8_t>(move)) << 16 |
+                              static_cast<std::uint32_t>(std::min(results[index].depth, 255)) << 24;
+        entries.emplace_back(key, value);
+    } // end for
+
+    std::sort(entries.begin(), entries.end());
+    entries.erase(std::unique(entries.begin(), entries.end(), [](const auto &left, const auto &right)
+                              { return left.first == right.first; }),
+                  entries.end());
+
+    BookHeader header{};
+    std::memcpy(header.magic, BOOK_MAGIC, sizeof(BOOK_MAGIC));
+    header.version = BOOK_VERSION;
+    header.byteOrder = BOOK_BYTE_ORDER;
+    header.rows = B::ROWS;
+    header.cols = B::COLS;
+    header.inARow = B::IN_A_ROW;
+    header.count = entries.size();
+
+    std::vector<std::uint64_t> keys;
+    std::vector<std::uint32_t> values;
+    for (const auto &[key, value] : entries)
+    {
+        keys.push_back(key);
+        values.push_back(value);
+    } // end for
+
+    std::FILE *file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr)
+    {
+        return false;
+    } // end if
+
+    bool written = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+                   std::fwrite(keys.data(), sizeof(std::uint64_t), keys.size(), file) == keys.size() &&
+                   std::fwrite(values.data(), sizeof(std::uint32_t), values.size(), file) == values.size();
+    return std::fclose(file) == 0 && written;
+} // end of function writeOpeningBook
+
+template <typename B>
+OpeningBook &openingBook()
+{
+    static OpeningBook book;
+    return book;
+} // end of function openingBook
+
+template <typename B>
+static bool openFor(const std::string &path, const BookHeader &header)
+{
+    if (header.rows != B::ROWS || header.cols != B::COLS || header.inARow != B::IN_A_ROW)
+    {
+        return false;
+    } // end if
+    return openingBook<B>().open(path, B::ROWS, B::COLS, B::IN_A_ROW);
+} // end of function openFor
+
+//
+// Open a book into the slot of the board size named in its header
+//
+bool loadOpeningBook(const std::string &path)
+{
+    BookHeader header{};
+    std::FILE *file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr)
+    {
+        return false;
+    } // end if
+    bool readHeader = std::fread(&header, sizeof(header), 1, file) == 1;
+    std::fclose(file);
+    if (!readHeader)
+    {
+        return false;
+    } // end if
+
+    return openFor<Board>(path, header) || openFor<Board4x4>(path, header) ||
+           openFor<Board5x5>(path, header) || openFor<Board7x7>(path, header);
+} // end of function loadOpeningBook
+
+template bool writeOpeningBook(const std::string &path, std::span<const Board> boards, std::span<const SearchResult> results);
+template bool writeOpeningBook(const std::string &path, std::span<const Board4x4> boards, std::span<const SearchResult> results);
+template bool writeOpeningBook(const std::string &path, std::span<const Board5x5> boards, std::span<const SearchResult> results);
+template bool writeOpeningBook(const std::string &path, std::span<const Board7x7> boards, std::span<const SearchResult> results);
+
+template OpeningBook &openingBook<Board>();
+template OpeningBook &openingBook<Board4x4>();
+template OpeningBook &openingBook<Board5x5>();
+template OpeningBook &openingBook<Board7x7>();
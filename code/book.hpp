@@ -0,0 +1,132 @@
+//
+// file: book.hpp
+// author: Michael Brockus
+// gmail: <michaelbrockus@gmail.com>
+//
+#ifndef BOOK_HPP
+#define BOOK_HPP
+
+#include "search.hpp"
+#include "symmetry.hpp"
+#include <cstdint>
+#include <span>
+#include <string>
+#include <type_traits>
+
+//
+// Opening book file layout, native byte order:
+//
+//     BookHeader                    32 bytes
+//     std::uint64_t keys[count]     sorted ascending
+//     std::uint32_t values[count]   score bits 0-15, move 16-23, depth 24-31
+//
+// The 3x3 board is keyed by its canonical position key with the move in
+// the canonical orientation, bigger boards by their Zobrist key. The file
+// is mapped read-only and searched in place, so opening it costs the same
+// whatever its size and every process using it shares the page cache.
+//
+const char BOOK_MAGIC[8] = {'T', 'T', 'D', 'B', 'O', 'O', 'K', '\0'};
+const std::uint32_t BOOK_VERSION = 2;
+const std::uint32_t BOOK_BYTE_ORDER = 0x01020304;
+const std::size_t BOOK_ENTRY_BYTES = sizeof(std::uint64_t) + sizeof(std::uint32_t);
+
+struct BookHeader
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byteOrder;
+    std::uint8_t rows;
+    std::uint8_t cols;
+    std::uint8_t inARow;
+    std::uint8_t reserved[5];
+    std::uint64_t count;
+};
+
+static_assert(sizeof(BookHeader) == 32, "the header is part of the file format");
+
+class OpeningBook
+{
+public:
+    OpeningBook() = default;
+    ~OpeningBook();
+
+    OpeningBook(const OpeningBook &) = delete;
+    OpeningBook &operator=(const OpeningBook &) = delete;
+
+    bool open(const std::string &path, int rows, int cols, int inARow);
+    void close();
+    bool isOpen() const;
+    std::size_t size() const;
+    bool find(std::uint64_t key, std::uint32_t &value) const;
+
+private:
+    void *mapping = nullptr;
+    std::size_t mappedBytes = 0;
+    const std::uint64_t *keys = nullptr;
+    const std::uint32_t *values = nullptr;
+    std::size_t count = 0;
+};
+
+//
+// Where a board and its move sit in the book
+//
+template <typename B>
+constexpr std::uint64_t bookKey(B board, int &symmetry)
+{
+    if constexpr (std::is_same_v<B, Board>)
+    {
+        CanonicalBoard canonical = canonicalize(board);
+        symmetry = canonical.symmetry;
+        return positionKey(canonical.board);
+    } // end if
+    else
+    {
+        symmetry = 0;
+        return zobristKey(board);
+    } // end else
+} // end of function bookKey
+
+//
+// Book answer for the board, false when the board is not in it
+//
+template <typename B>
+bool probeBook(const OpeningBook &book, B board, SearchResult &result)
+{
+    int symmetry;
+    std::uint32_t value;
+    if (!book.find(bookKey(board, symmetry), value))
+    {
+        return false;
+    } // end if
+
+    result = SearchResult{};
+    result.score = static_cast<std::int16_t>(value & 0xFFFF);
+    result.move = static_cast<std::int8_t>((value >> 16) & 0xFF);
+    result.depth = static_cast<int>(value >> 24);
+    if constexpr (std::is_same_v<B, Board>)
+    {
+        result.move = moveFromCanonical(result.move, symmetry);
+    } // end if
+    result.line.moves[0] = static_cast<std::int8_t>(result.move);
+    result.line.length = result.move == NO_MOVE ? 0 : 1;
+    return true;
+} // end of function probeBook
+
+//
+// Write the results of searching boards as a book, boards sharing a key
+// are stored once
+//
+template <typename B>
+bool writeOpeningBook(const std::string &path, std::span<const B> boards, std::span<const SearchResult> results);
+
+//
+// Book consulted by findBestMove for each board size, empty until
+// loadOpeningBook opens a file made for that size. Load books at startup,
+// before any search runs.
+//
+template <typename B>
+OpeningBook &openingBook();
+
+bool loadOpeningBook(const std::string &path);
+
+#endif // end of BOOK_HPP
@@ -0,0 +1,148 @@
+//
+// file: engine.cpp
+// author: Michael Brockus
+// gmail: <michaelbrockus@gmail.com>
+//
+// USE CASE:
+//
+// The search state of a game that lasts more than one move. A search
+// proves far more than the move it returns, the values of the replies it
+// looked at most of all, and a game usually goes on into one of those
+// replies. Keeping the table between moves turns that work into hits on
+// the next search instead of doing it again.
+//
+#include "engine.hpp"
+#include "book.hpp"
+#include "solved.hpp"
+#include "tablebase.hpp"
+#include <algorithm>
+#include <bit>
+#include <type_traits>
+
+//
+// Entries that fit in memoryBytes, the 3x3 board never needing more than
+// its perfect table
+//
+template <typename B>
+static std::size_t engineEntries(std::size_t memoryBytes)
+{
+    std::size_t entries = std::max<std::size_t>(1, memoryBytes / TABLE_SLOT_BYTES);
+    if constexpr (std::is_same_v<B, Board>)
+    {
+        entries = std::min<std::size_t>(entries, std::bit_ceil(2u * POSITION_COUNT));
+    } // end if
+    return std::bit_floor(entries);
+} // end of function engineEntries
+
+template <typename B>
+Engine<B>::Engine(std::size_t memoryBytes, ThreadPool *pool)
+    : searchTable(engineEntries<B>(memoryBytes)), pool(pool)
+{
+} // end of constructor
+
+//
+// Start a game from start, keeping what the table knows
+//
+template <typename B>
+void Engine<B>::newGame(B start)
+{
+    root = Position<B>(start);
+} // end of function newGame
+
+template <typename B>
+void Engine<B>::play(int cell)
+{
+    root.make(cell);
+} // end of function play
+
+//
+// Follow the game to board. When it only adds marks to the current one,
+// taking turns, they are played as moves, otherwise the game starts over
+// from board.
+//
+template <typename B>
+void Engine<B>::setBoard(B board)
+{
+    const B &current = root.board();
+    if ((current.x & ~board.x) != 0 || (current.o & ~board.o) != 0)
+    {
+        newGame(board);
+        return;
+    } // end if
+
+    typename B::Mask newX = board.x & ~current.x;
+    typename B::Mask newO = board.o & ~current.o;
+    while ((newX | newO) != 0)
+    {
+        typename B::Mask &moves = root.xMoves() ? newX : newO;
+        if (moves == 0 || root.gameOver())
+        {
+            newGame(board);
+            return;
+        } // end if
+
+        root.make(std::countr_zero(moves));
+        moves &= moves - 1;
+    } // end while
+
+} // end of function setBoard
+
+//
+// Forget everything, the table and the game
+//
+template <typename B>
+void Engine<B>::clear()
+{
+    searchTable.clear();
+    newGame();
+} // end of function clear
+
+//
+// Best move in the current position. The 3x3 board is answered from the
+// solved table, the others from the opening book or the tablebase when
+// they have it and searched otherwise.
+//
+template <typename B>
+SearchResult Engine<B>::think(const SearchLimits &limits)
+{
+    SearchResult result;
+    if constexpr (std::is_same_v<B, Board>)
+    {
+        SolvedEntry entry = lookupSolved(root.board());
+        result.move = entry.move;
+        result.score = entry.score;
+        result.depth = root.emptyCount();
+        if (entry.move != NO_MOVE)
+        {
+            result.line.moves[0] = static_cast<std::int8_t>(entry.move);
+            result.line.length = 1;
+        } // end if
+        return result;
+    } // end if
+
+    if (probeBook(openingBook<B>(), root.board(), result) || probeTablebase(endgameTablebase<B>(), root.board(), result))
+    {
+        return result;
+    } // end if
+
+    searchTable.newSearch();
+    return pool != nullptr ? parallelSearch(root, limits, searchTable, *pool)
+                           : iterativeDeepeningSearch(root, limits, searchTable);
+} // end of function think
+
+template <typename B>
+const Position<B> &Engine<B>::position() const
+{
+    return root;
+} // end of function position
+
+template <typename B>
+TranspositionTable &Engine<B>::table()
+{
+    return searchTable;
+} // end of function table
+
+template class Engine<Board>;
+template class Engine<Board4x4>;
+template class Engine<Board5x5>;
+template class Engine<Board7x7>;
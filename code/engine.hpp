@@ -0,0 +1,52 @@
+//
+// file: engine.hpp
+// author: Michael Brockus
+// gmail: <michaelbrockus@gmail.com>
+//
+#ifndef ENGINE_HPP
+#define ENGINE_HPP
+
+#include "search.hpp"
+#include <cstddef>
+
+//
+// Table memory of an engine unless told otherwise, 16 MB
+const std::size_t DEFAULT_ENGINE_MEMORY = std::size_t{1} << 24;
+
+//
+// A player that remembers. The engine keeps its own transposition table
+// from one move to the next and follows the game as it is played, so the
+// positions it searched last turn are already in the table when the game
+// reaches them. The table never grows past the memory it was given, rounded
+// down to a power of two entries, and every think ages what is stored so
+// older searches give way first once it is full. On the 3x3 board there
+// is nothing to search, think answers from the solved table.
+//
+// One engine per game, or one shared by games played one after another.
+// An engine is used by one thread at a time.
+//
+template <typename B>
+class Engine
+{
+public:
+    explicit Engine(std::size_t memoryBytes = DEFAULT_ENGINE_MEMORY, ThreadPool *pool = nullptr);
+
+    Engine(const Engine &) = delete;
+    Engine &operator=(const Engine &) = delete;
+
+    void newGame(B start = B{});
+    void play(int cell);
+    void setBoard(B board);
+    void clear();
+    SearchResult think(const SearchLimits &limits);
+
+    const Position<B> &position() const;
+    TranspositionTable &table();
+
+private:
+    TranspositionTable searchTable;
+    Position<B> root;
+    ThreadPool *pool;
+};
+
+#endif // end of ENGINE_HPP
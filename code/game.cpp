@@ -4,136 +4,128 @@
 // gmail: <michaelbrockus@gmail.com>
 //
 #include "game.hpp"
+#include "solved.hpp"
 #include <iostream>
 #include <algorithm>
-
-// All possible winning states
-std::vector<std::vector<std::pair<int, int>>> winningStates{
-    // Every row
-    {{0, 0}, {0, 1}, {0, 2}},
-    {{1, 0}, {1, 1}, {1, 2}},
-    {{2, 0}, {2, 1}, {2, 2}},
-
-    // Every column
-    {{0, 0}, {1, 0}, {2, 0}},
-    {{0, 1}, {1, 1}, {2, 1}},
-    {{0, 2}, {1, 2}, {2, 2}},
-
-    // Every diagonal
-    {{0, 0}, {1, 1}, {2, 2}},
-    {{2, 0}, {1, 1}, {0, 2}}};
+#include <cstdint>
 
 //
-// Get all available legal moves (spaces that are not occupied)
+// Convert the char grid into X and O occupancy masks
 //
-std::vector<std::pair<int, int>> getLegalMoves(std::array<std::array<char, 3>, 3> board)
+Board toBoard(const Grid &board)
 {
-    std::vector<std::pair<int, int>> legalMoves;
-    for (size_t row = 0; row < 3; ++row)
+    Board bits;
+    for (int row = 0; row < 3; ++row)
     {
-        for (size_t col = 0; col < 3; ++col)
+        for (int col = 0; col < 3; ++col)
         {
-            if (board[row][col] != AI_MARKER && board[row][col] != PLAYER_MARKER)
+            if (board[row][col] == PLAYER_MARKER)
             {
-                legalMoves.push_back({row, col});
+                bits.x |= cellMask(cellIndex(row, col));
             } // end if
+            else if (board[row][col] == AI_MARKER)
+            {
+                bits.o |= cellMask(cellIndex(row, col));
+            } // end else if
 
         } // end for
 
     } // end for
 
-    return legalMoves;
-} // end of function getLegalMoves
+    return bits;
+} // end of function toBoard
 
 //
-// Check if a position is occupied
+// Convert a list of positions into a cell mask, off board positions are ignored
 //
-bool positionOccupied(std::array<std::array<char, 3>, 3> board, std::pair<int, int> pos)
+Mask toMask(const std::vector<std::pair<int, int>> &positions)
 {
-    std::vector<std::pair<int, int>> legalMoves = getLegalMoves(board);
-
-    for (size_t index = 0; index < legalMoves.size(); ++index)
+    Mask cells = 0;
+    for (const std::pair<int, int> &pos : positions)
     {
-        if (pos.first == legalMoves[index].first && pos.second == legalMoves[index].second)
+        if (pos.first >= 0 && pos.first < 3 && pos.second >= 0 && pos.second < 3)
         {
-            return false;
+            cells |= cellMask(cellIndex(pos.first, pos.second));
         } // end if
 
     } // end for
 
-    return true;
-} // end of function positionOccupied
+    return cells;
+} // end of function toMask
 
 //
-// Get all board positions occupied by the given marker
+// Convert a cell mask into a list of positions in row major order
 //
-std::vector<std::pair<int, int>> getOccupiedPositions(std::array<std::array<char, 3>, 3> board, char marker)
+std::vector<std::pair<int, int>> toPositions(Mask cells)
 {
-    std::vector<std::pair<int, int>> occupiedPositions;
-
-    for (size_t row = 0; row < 3; ++row)
+    std::vector<std::pair<int, int>> positions;
+    positions.reserve(std::popcount(cells));
+    for (; cells != 0; cells &= cells - 1)
     {
-        for (size_t col = 0; col < 3; ++col)
-        {
-            if (marker == board[row][col])
-            {
-                occupiedPositions.push_back({row, col});
-            } // end if
-
-        } // end for
-
+        int cell = std::countr_zero(cells);
+        positions.push_back({cell / 3, cell % 3});
     } // end for
 
-    return occupiedPositions;
-} // end of function getOccupiedPositions
+    return positions;
+} // end of function toPositions
 
 //
-// Check if the board is full
+// Get all available legal moves (spaces that are not occupied)
 //
-bool boardIsFull(std::array<std::array<char, 3>, 3> board)
+std::vector<std::pair<int, int>> getLegalMoves(const Grid &board)
 {
-    std::vector<std::pair<int, int>> legal_moves = getLegalMoves(board);
+    return toPositions(legalMoveMask(toBoard(board)));
+} // end of function getLegalMoves
 
-    if (0 == legal_moves.size())
+//
+// Check if a position is occupied, off board positions count as occupied
+//
+bool positionOccupied(const Grid &board, std::pair<int, int> pos)
+{
+    if (pos.first < 0 || pos.first >= 3 || pos.second < 0 || pos.second >= 3)
     {
         return true;
     } // end if
-    else
-    {
-        return false;
-    } // end else
-} // end of function boardIsFull
+
+    return (occupiedCells(toBoard(board)) & cellMask(cellIndex(pos.first, pos.second))) != 0;
+} // end of function positionOccupied
 
 //
-// Check if the game has been won
+// Get all board positions occupied by the given marker
 //
-bool gameIsWon(std::vector<std::pair<int, int>> occupiedPositions)
+std::vector<std::pair<int, int>> getOccupiedPositions(const Grid &board, char marker)
 {
-    bool game_won;
-
-    for (size_t winIndex = 0; winIndex < winningStates.size(); winIndex++)
+    Board bits = toBoard(board);
+    if (marker == PLAYER_MARKER)
     {
-        game_won = true;
-        std::vector<std::pair<int, int>> curr_win_state = winningStates[winIndex];
-        for (int index = 0; index < 3; index++)
-        {
-            if (!(std::find(std::begin(occupiedPositions),
-                            std::end(occupiedPositions),
-                            curr_win_state[index]) != std::end(occupiedPositions)))
-            {
-                game_won = false;
-                break;
-            } // end if
+        return toPositions(bits.x);
+    } // end if
+    else if (marker == AI_MARKER)
+    {
+        return toPositions(bits.o);
+    } // end else if
+    else if (marker == EMPTY_SPACE)
+    {
+        return toPositions(legalMoveMask(bits));
+    } // end else if
 
-        } // end for
+    return {};
+} // end of function getOccupiedPositions
 
-        if (game_won)
-        {
-            break;
-        } // end if
+//
+// Check if the board is full
+//
+bool boardIsFull(const Grid &board)
+{
+    return boardFull(toBoard(board));
+} // end of function boardIsFull
 
-    } // end for
-    return game_won;
+//
+// Check if the game has been won
+//
+bool gameIsWon(const std::vector<std::pair<int, int>> &occupiedPositions)
+{
+    return hasWinningLine(toMask(occupiedPositions));
 } // end of function gameIsWon
 
 //
@@ -157,60 +149,36 @@ char getOpponentMarker(char marker)
 //
 // Check if someone has won or lost
 //
-int getBoardState(std::array<std::array<char, 3>, 3> board, char marker)
+int getBoardState(const Grid &board, char marker)
 {
-
-    char opponentMarker = getOpponentMarker(marker);
-
-    std::vector<std::pair<int, int>> occupiedPositions = getOccupiedPositions(board, marker);
-
-    if (gameIsWon(occupiedPositions))
-    {
-        return static_cast<int>(State::WIN);
-    } // end if
-
-    occupiedPositions = getOccupiedPositions(board, opponentMarker);
-
-    if (gameIsWon(occupiedPositions))
-    {
-        return static_cast<int>(State::LOSS);
-    } // end if
-
-    if (boardIsFull(board))
-    {
-        return static_cast<int>(State::DRAW);
-    } // end if
-
-    return static_cast<int>(State::DRAW);
+    return boardState(toBoard(board), marker == PLAYER_MARKER);
 } // end of function getBoardState
 
 //
 // Apply the minimax game optimization algorithm
 //
-static std::pair<int, std::pair<int, int>> minimax(std::array<std::array<char, 3>, 3> board, char optForMarker, bool isMax)
+template <typename B>
+static std::pair<int, int> minimax(Position<B> &position, bool optForX, bool isMax, int ply, std::uint64_t &nodes)
 {
-    //
-    // Initialize best move
-    std::pair<int, int> bestMove = {-1, -1};
-
-    //
-    // Get a list of the empty board locations.
-    std::vector<std::pair<int, int>> legalMoves = getLegalMoves(board);
+    ++nodes;
 
     //
-    // Determine which marker we are working with based on the number of
-    // empty spaces... An odd number indicates it is the PLAYER's turn.
-    char marker = (legalMoves.size() & 1) ? PLAYER_MARKER : AI_MARKER;
+    // Initialize best move
+    int bestMove = NO_MOVE;
 
     //
-    // Get the current state of the board from the marker we are optimizing for.
-    int boardState = getBoardState(board, optForMarker);
+    // Get a mask of the empty board locations.
+    typename B::Mask legalMoves = position.legalMoves();
 
     //
-    // If we have no more moves to make then return a WIN, LOSE or DRAW value.
-    if ((legalMoves.size() == 0) || (boardState != static_cast<int>(State::DRAW)))
+    // If we have no more moves to make then return a WIN, LOSE or DRAW
+    // value, from the marker we are optimizing for. A win or loss counts
+    // the plies it took, so a quick win beats a slow one.
+    if (position.gameOver())
     {
-        return {boardState, bestMove};
+        int boardScore = position.state();
+        boardScore = boardScore > 0 ? boardScore - ply : boardScore < 0 ? boardScore + ply : boardScore;
+        return {position.xMoves() == optForX ? boardScore : -boardScore, bestMove};
     } // end if
 
     //
@@ -218,15 +186,13 @@ static std::pair<int, std::pair<int, int>> minimax(std::array<std::array<char, 3
     int bestScore = isMax ? INT32_MIN : INT32_MAX;
 
     //
-    // Go through all of the open positions and see how they score.
-    for (size_t index = 0; index < legalMoves.size(); ++index)
+    // Go through all of the open positions in row major order and see how they score.
+    for (; legalMoves != 0; legalMoves &= legalMoves - 1)
     {
-        //
-        // Set the current location, score it and then restore as empty.
-        std::pair<int, int> currMove = legalMoves[index];
-        board[currMove.first][currMove.second] = marker;
-        int newScore = minimax(board, optForMarker, !isMax).first;
-        board[currMove.first][currMove.second] = EMPTY_SPACE;
+        int currMove = std::countr_zero(legalMoves);
+        position.make(currMove);
+        int newScore = minimax(position, optForX, !isMax, ply + 1, nodes).first;
+        position.unmake(currMove);
 
         //
         // Track the appropriate MAX or MIN score. Short circuit the
@@ -237,7 +203,7 @@ static std::pair<int, std::pair<int, int>> minimax(std::array<std::array<char, 3
             {
                 bestMove = currMove;
                 bestScore = newScore;
-                if (bestScore == static_cast<int>(State::WIN))
+                if (bestScore == static_cast<int>(State::WIN) - ply - 1)
                 {
                     break;
                 } // end if
@@ -251,7 +217,7 @@ static std::pair<int, std::pair<int, int>> minimax(std::array<std::array<char, 3
             {
                 bestMove = currMove;
                 bestScore = newScore;
-                if (bestScore == static_cast<int>(State::LOSS))
+                if (bestScore == static_cast<int>(State::LOSS) + ply + 1)
                 {
                     break;
                 } // end if
@@ -264,50 +230,124 @@ static std::pair<int, std::pair<int, int>> minimax(std::array<std::array<char, 3
     return {bestScore, bestMove};
 } // end of function minimax
 
-std::pair<int, int> findBestMove(std::array<std::array<char, 3>, 3> board)
+//
+// Reference search without pruning or caching, kept to measure and
+// check the optimized search against. It walks the whole tree below the
+// board, which on the bigger boards is only practical near the end of
+// the game.
+//
+template <typename B>
+SearchResult minimaxSearch(B board)
 {
-    //
-    // Get a list of the empty board locations.
-    std::vector<std::pair<int, int>> legalMoves = getLegalMoves(board);
+    SearchResult result;
+    Position<B> position(board);
+    std::pair<int, int> scored = minimax(position, position.xMoves(), true, 0, result.nodes);
+    result.score = scored.first;
+    result.move = scored.second;
+    return result;
+} // end of function minimaxSearch
+
+std::pair<int, int> findBestMove(const Grid &board)
+{
+    int bestMove = lookupSolved(toBoard(board)).move;
+    if (bestMove == NO_MOVE)
+    {
+        return {NO_MOVE, NO_MOVE};
+    } // end if
 
-    //
-    // Determine which marker we are working with based on the number of
-    // empty spaces... An odd number indicates it is the PLAYER's turn.
-    char marker = (legalMoves.size() & 1) ? PLAYER_MARKER : AI_MARKER;
+    return {bestMove / 3, bestMove % 3};
+} // end of function findBestMove
+
+//
+// Best move for every board in the batch, only min(boards, moves) boards
+// are looked at. Keys for a block of boards are built first and looked up
+// after, which keeps the conversion loop free of table loads so the
+// compiler can vectorize it and the lookups can overlap.
+//
+void findBestMoves(std::span<const Grid> boards, std::span<std::pair<int, int>> moves)
+{
+    const std::size_t BLOCK_SIZE = 256;
+    std::array<std::uint32_t, BLOCK_SIZE> keys;
+    std::size_t count = std::min(boards.size(), moves.size());
+    for (std::size_t start = 0; start < count; start += BLOCK_SIZE)
+    {
+        std::size_t blockSize = std::min(BLOCK_SIZE, count - start);
+        for (std::size_t index = 0; index < blockSize; ++index)
+        {
+            const Grid &grid = boards[start + index];
+            std::uint32_t key = 0;
+            std::uint32_t weight = 1;
+            for (int cell = 0; cell < BOARD_CELLS; ++cell)
+            {
+                char mark = grid[cell / 3][cell % 3];
+                key += weight * ((mark == PLAYER_MARKER) + 2 * (mark == AI_MARKER));
+                weight *= 3;
+            } // end for
+            keys[index] = key;
+        } // end for
 
-    return minimax(board, marker, true).second;
-}
+        for (std::size_t index = 0; index < blockSize; ++index)
+        {
+            int bestMove = lookupSolved(keys[index]).move;
+            moves[start + index] = bestMove == NO_MOVE ? std::pair<int, int>{NO_MOVE, NO_MOVE}
+                                                       : std::pair<int, int>{bestMove / 3, bestMove % 3};
+        } // end for
+
+    } // end for
+} // end of function findBestMoves
 
 //
 // Check if the game is finished
 //
-const bool gameIsDone(std::array<std::array<char, 3>, 3> board)
+const bool gameIsDone(const Grid &board)
 {
-    if (boardIsFull(board))
+    Board bits = toBoard(board);
+    if (boardFull(bits))
     {
         return true;
     } // end if
 
-    if (static_cast<int>(State::DRAW) != getBoardState(board, AI_MARKER))
+    if (static_cast<int>(State::DRAW) != boardState(bits, false))
     {
         return true;
     } // end if
 
     return false;
-} // end of function findBestMove
+} // end of function gameIsDone
+
+//
+// Name of the state a board is in, X is the player and O the engine
+//
+const char *gameStateName(Board board)
+{
+    if (hasWinningLine(board.x))
+    {
+        return "x-wins";
+    } // end if
+    else if (hasWinningLine(board.o))
+    {
+        return "o-wins";
+    } // end else if
+    else if (boardFull(board))
+    {
+        return "draw";
+    } // end else if
+
+    return "playing";
+} // end of function gameStateName
 
 //
 // Print the current board state
 //
-void printBoard(std::array<std::array<char, 3>, 3> board)
+void printBoard(const Grid &board)
 {
-    std::cout << std::endl;
-    std::cout << " " << board[0][0] << " | " << board[0][1] << " | " << board[0][2] << std::endl;
-    std::cout << "-----------" << std::endl;
-    std::cout << " " << board[1][0] << " | " << board[1][1] << " | " << board[1][2] << std::endl;
-    std::cout << "-----------" << std::endl;
-    std::cout << " " << board[2][0] << " | " << board[2][1] << " | " << board[2][2] << std::endl
-              << std::endl;
+    //
+    // One write and no flush, std::cin is tied to std::cout so the
+    // board still shows up before the next prompt is read
+    std::cout << "\n " << board[0][0] << " | " << board[0][1] << " | " << board[0][2]
+              << "\n-----------\n " << board[1][0] << " | " << board[1][1] << " | " << board[1][2]
+              << "\n-----------\n " << board[2][0] << " | " << board[2][1] << " | " << board[2][2]
+              << "\n\n";
 } // end of function printPoard
 
 //
@@ -328,3 +368,8 @@ void printGameState(int state)
         std::cout << "LOSS" << std::endl;
     } // end else if
 } // end of function printGameState
+
+template SearchResult minimaxSearch(Board board);
+template SearchResult minimaxSearch(Board4x4 board);
+template SearchResult minimaxSearch(Board5x5 board);
+template SearchResult minimaxSearch(Board7x7 board);
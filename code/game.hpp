@@ -6,15 +6,13 @@
 #ifndef GAME_HPP
 #define GAME_HPP
 
+#include "board.hpp"
+#include "search.hpp"
 #include <vector>
 #include <array>
+#include <span>
 
-enum class State
-{
-    WIN = 1000,
-    DRAW = 0,
-    LOSS = -1000
-};
+using Grid = std::array<std::array<char, 3>, 3>;
 
 const char AI_MARKER = 'O';
 const char PLAYER_MARKER = 'X';
@@ -24,21 +22,35 @@ const int START_DEPTH = 0;
 
 //
 // Testing prototypes
-void printBoard(std::array<std::array<char, 3>, 3> board);
+void printBoard(const Grid &board);
 void printGameState(int state);
 char getOpponentMarker(char marker);
-std::vector<std::pair<int, int>> getLegalMoves(std::array<std::array<char, 3>, 3> board);
-bool positionOccupied(std::array<std::array<char, 3>, 3> board, std::pair<int, int> pos);
-std::vector<std::pair<int, int>> getOccupiedPositions(std::array<std::array<char, 3>, 3> board, char marker);
-bool boardIsFull(std::array<std::array<char, 3>, 3> board);
-bool gameIsWon(std::vector<std::pair<int, int>> occupiedPositions);
-int getBoardState(std::array<std::array<char, 3>, 3> board, char marker);
-std::pair<int, int> findBestMove(std::array<std::array<char, 3>, 3> board);
-const bool gameIsDone(std::array<std::array<char, 3>, 3> board);
+std::vector<std::pair<int, int>> getLegalMoves(const Grid &board);
+bool positionOccupied(const Grid &board, std::pair<int, int> pos);
+std::vector<std::pair<int, int>> getOccupiedPositions(const Grid &board, char marker);
+bool boardIsFull(const Grid &board);
+bool gameIsWon(const std::vector<std::pair<int, int>> &occupiedPositions);
+int getBoardState(const Grid &board, char marker);
+std::pair<int, int> findBestMove(const Grid &board);
+void findBestMoves(std::span<const Grid> boards, std::span<std::pair<int, int>> moves);
+const bool gameIsDone(const Grid &board);
+
+//
+// Bitboard adapters
+Board toBoard(const Grid &board);
+Mask toMask(const std::vector<std::pair<int, int>> &positions);
+std::vector<std::pair<int, int>> toPositions(Mask cells);
+const char *gameStateName(Board board);
+
+//
+// Reference search, defined in game.cpp for Board, Board4x4, Board5x5
+// and Board7x7
+template <typename B>
+SearchResult minimaxSearch(B board);
 
 //
 // Game helpers
-void printBoard(std::array<std::array<char, 3>, 3> board);
+void printBoard(const Grid &board);
 void printGameState(int state);
 
 #endif // end of GAME_H
\ No newline at end of file
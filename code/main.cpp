@@ -3,11 +3,139 @@
 // author: Michael Brockus
 // gmail: <michaelbrockus@gmail.com>
 //
+#include "batch.hpp"
+#include "book.hpp"
 #include "program.hpp"
+#include "server.hpp"
+#include "stats.hpp"
+#include "tablebase.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
 
+#if defined(__linux__)
+#include <signal.h>
+#endif
 
-// main is where program execution starts
-int main(void)
+#if defined(__linux__)
+//
+// Server the signal handler asks to stop, stop() only sets an atomic flag
+static GameServer *runningServer = nullptr;
+
+static void stopServer(int)
+{
+    if (runningServer != nullptr)
+    {
+        runningServer->stop();
+    } // end if
+} // end of function stopServer
+
+//
+// Stop the server on SIGINT and SIGTERM so it closes its connections and
+// removes the socket file, without SA_RESTART so epoll_wait returns early
+//
+static void handleStopSignals(GameServer &server)
+{
+    runningServer = &server;
+    struct sigaction action{};
+    action.sa_handler = stopServer;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+} // end of function handleStopSignals
+#endif
+
+//
+// --server [socket path] runs the headless game server and --batch
+// [input] [output] analyzes a file of positions instead of the
+// interactive game, - meaning the standard stream
+//
+static int runMode(int argc, char **argv)
 {
+    if (argc > 1 && std::string(argv[1]) == "--server")
+    {
+        GameServer server;
+#if defined(__linux__)
+        handleStopSignals(server);
+#endif
+        return server.run(argc > 2 ? argv[2] : DEFAULT_SOCKET_PATH);
+    } // end if
+
+    if (argc > 1 && std::string(argv[1]) == "--batch")
+    {
+        bool fromStdin = argc < 3 || std::string(argv[2]) == "-";
+        bool toStdout = argc < 4 || std::string(argv[3]) == "-";
+        std::FILE *input = fromStdin ? stdin : std::fopen(argv[2], "rb");
+        std::FILE *output = toStdout ? stdout : std::fopen(argv[3], "wb");
+        if (input == nullptr || output == nullptr)
+        {
+            std::perror("tic-tac-dodo --batch");
+            return EXIT_FAILURE;
+        } // end if
+
+        ThreadPool pool;
+        int status = runBatch(input, output, pool);
+        if (!fromStdin)
+        {
+            std::fclose(input);
+        } // end if
+        if (!toStdout && std::fclose(output) != 0)
+        {
+            status = EXIT_FAILURE;
+        } // end if
+        return status;
+    } // end if
+
     return foundation();
-} // end of function main
\ No newline at end of file
+} // end of function runMode
+
+// main is where program execution starts
+int main(int argc, char **argv)
+{
+    //
+    // --stats, --book <file> and --tablebase <file> may come in front of
+    // any mode. The stats totals go to stderr once the mode is done, the
+    // book and the tablebase are mapped before it starts.
+    bool printStats = false;
+    while (argc > 1)
+    {
+        std::string option = argv[1];
+        if (option == "--stats")
+        {
+            printStats = true;
+        } // end if
+        else if (option == "--book" && argc > 2)
+        {
+            if (!loadOpeningBook(argv[2]))
+            {
+                std::fprintf(stderr, "cannot open book %s\n", argv[2]);
+                return EXIT_FAILURE;
+            } // end if
+            --argc;
+            ++argv;
+        } // end else if
+        else if (option == "--tablebase" && argc > 2)
+        {
+            if (!loadTablebase(argv[2]))
+            {
+                std::fprintf(stderr, "cannot open tablebase %s\n", argv[2]);
+                return EXIT_FAILURE;
+            } // end if
+            --argc;
+            ++argv;
+        } // end else if
+        else
+        {
+            break;
+        } // end else
+        --argc;
+        ++argv;
+    } // end while
+
+    int status = runMode(argc, argv);
+    if (printStats)
+    {
+        std::fprintf(stderr, "stats %s\n", formatStats(searchTotals()).c_str());
+    } // end if
+    return status;
+} // end of function main
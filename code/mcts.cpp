@@ -0,0 +1,374 @@
+//
+// file: mcts.cpp
+// author: Michael Brockus
+// gmail: <michaelbrockus@gmail.com>
+//
+// USE CASE:
+//
+// Monte Carlo tree search for boards too big for alpha-beta to see the
+// end of. Every playout walks down the tree picking children by UCT,
+// grows the tree by one block of children and plays the rest of the game
+// out at random on the bitboards, then adds its result to every node on
+// the way back up. Threads share one tree, counters are atomics and a
+// node is expanded by whichever thread claims it first.
+//
+#include "mcts.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <mutex>
+
+//
+// Weight of trying rarely played moves against the ones scoring best
+const double UCT_EXPLORATION = 1.41421356;
+
+//
+// A leaf gets its children once it has been visited this many times
+const std::uint32_t EXPAND_VISITS = 2;
+
+const std::uint8_t UNEXPANDED = 0;
+const std::uint8_t EXPANDING = 1;
+const std::uint8_t EXPANDED = 2;
+
+const std::uint64_t PLAYOUT_SEED = 0x9E3779B97F4A7C15ull;
+
+MctsTree::MctsTree(std::size_t capacity) : nodes(capacity < 1 ? 1 : capacity)
+{
+    clear();
+} // end of constructor
+
+//
+// Forget the tree, leaving a bare root. Not safe while a search runs.
+//
+void MctsTree::clear()
+{
+    MctsNode &root = nodes[0];
+    root.visits.store(0, std::memory_order_relaxed);
+    root.reward.store(0, std::memory_order_relaxed);
+    root.firstChild.store(0, std::memory_order_relaxed);
+    root.expansion.store(UNEXPANDED, std::memory_order_relaxed);
+    root.childCount = 0;
+    used.store(1, std::memory_order_relaxed);
+} // end of function clear
+
+//
+// Index of the first of count fresh nodes, 0 when the pool is used up.
+// The nodes are not reset, the caller fills them in before publishing.
+//
+std::uint32_t MctsTree::allocate(std::uint32_t count)
+{
+    if (used.load(std::memory_order_relaxed) + count > nodes.size())
+    {
+        return 0;
+    } // end if
+
+    std::uint32_t start = used.fetch_add(count, std::memory_order_relaxed);
+    if (start + count > nodes.size())
+    {
+        return 0;
+    } // end if
+    return start;
+} // end of function allocate
+
+MctsNode &MctsTree::node(std::uint32_t index)
+{
+    return nodes[index];
+} // end of function node
+
+std::size_t MctsTree::capacity() const
+{
+    return nodes.size();
+} // end of function capacity
+
+std::size_t MctsTree::nodeCount() const
+{
+    return std::min<std::size_t>(used.load(std::memory_order_relaxed), nodes.size());
+} // end of function nodeCount
+
+//
+// xorshift64*, one generator per thread
+//
+static std::uint64_t nextRandom(std::uint64_t &state)
+{
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 0x2545F4914F6CDD1Dull;
+} // end of function nextRandom
+
+//
+// Play random moves to the end of the game, the result is 1 when X won,
+// -1 when O won and 0 for a draw
+//
+template <typename B>
+static int playout(Position<B> &position, std::uint64_t &random)
+{
+    std::array<std::uint8_t, B::CELLS> empty;
+    int emptyCount = 0;
+    for (typename B::Mask moves = position.legalMoves(); moves != 0; moves &= moves - 1)
+    {
+        empty[emptyCount++] = static_cast<std::uint8_t>(std::countr_zero(moves));
+    } // end for
+
+    while (!position.gameOver())
+    {
+        int pick = static_cast<int>(((nextRandom(random) >> 32) * static_cast<std::uint64_t>(emptyCount)) >> 32);
+        position.make(empty[pick]);
+        empty[pick] = empty[--emptyCount];
+    } // end while
+
+    int state = position.state();
+    if (state == static_cast<int>(State::DRAW))
+    {
+        return 0;
+    } // end if
+    return (state == static_cast<int>(State::WIN)) == position.xMoves() ? 1 : -1;
+} // end of function playout
+
+//
+// Give the node one child per legal move, unless another thread is at it
+// or the pool is used up
+//
+template <typename B>
+static void expand(MctsTree &tree, MctsNode &node, const Position<B> &position)
+{
+    std::uint8_t expected = UNEXPANDED;
+    if (!node.expansion.compare_exchange_strong(expected, EXPANDING, std::memory_order_acquire))
+    {
+        return;
+    } // end if
+
+    typename B::Mask legalMoves = position.legalMoves();
+    std::uint32_t count = static_cast<std::uint32_t>(std::popcount(legalMoves));
+    std::uint32_t start = tree.allocate(count);
+    if (start == 0)
+    {
+        node.expansion.store(UNEXPANDED, std::memory_order_release);
+        return;
+    } // end if
+
+    std::uint32_t index = start;
+    for (int cell : B::MOVE_ORDER)
+    {
+        if ((legalMoves & B::cellMask(cell)) == 0)
+        {
+            continue;
+        } // end if
+
+        MctsNode &child = tree.node(index++);
+        child.visits.store(0, std::memory_order_relaxed);
+        child.reward.store(0, std::memory_order_relaxed);
+        child.firstChild.store(0, std::memory_order_relaxed);
+        child.expansion.store(UNEXPANDED, std::memory_order_relaxed);
+        child.move = static_cast<std::uint8_t>(cell);
+        child.childCount = 0;
+    } // end for
+
+    node.childCount = static_cast<std::uint8_t>(count);
+    node.firstChild.store(start, std::memory_order_relaxed);
+    node.expansion.store(EXPANDED, std::memory_order_release);
+} // end of function expand
+
+//
+// Child with the best upper confidence bound, an unvisited one first
+//
+static std::uint32_t selectChild(MctsTree &tree, const MctsNode &node)
+{
+    std::uint32_t first = node.firstChild.load(std::memory_order_relaxed);
+    double logVisits = std::log(static_cast<double>(node.visits.load(std::memory_order_relaxed)));
+    std::uint32_t best = first;
+    double bestBound = -1.0;
+    for (std::uint32_t index = first; index < first + node.childCount; ++index)
+    {
+        const MctsNode &child = tree.node(index);
+        std::uint32_t visits = child.visits.load(std::memory_order_relaxed);
+        if (visits == 0)
+        {
+            return index;
+        } // end if
+
+        double bound = child.reward.load(std::memory_order_relaxed) / (2.0 * visits) +
+                       UCT_EXPLORATION * std::sqrt(logVisits / visits);
+        if (bound > bestBound)
+        {
+            bestBound = bound;
+            best = index;
+        } // end if
+
+    } // end for
+
+    return best;
+} // end of function selectChild
+
+//
+// State shared by the threads of one tree search
+//
+struct SharedPlayouts
+{
+    std::atomic<std::uint64_t> started{0};
+    std::atomic<bool> stop{false};
+};
+
+//
+// Run playouts until the budget is spent
+//
+template <typename B>
+static void runPlayouts(const Position<B> &root, const MctsLimits &limits, std::uint64_t maxPlayouts,
+                        MctsTree &tree, SharedPlayouts &shared, std::uint64_t seed)
+{
+    std::uint64_t random = seed;
+    std::array<std::uint32_t, B::CELLS + 1> path;
+    for (std::uint64_t local = 1;; ++local)
+    {
+        if (shared.stop.load(std::memory_order_relaxed) ||
+            shared.started.fetch_add(1, std::memory_order_relaxed) >= maxPlayouts)
+        {
+            break;
+        } // end if
+
+        if (local % MCTS_CLOCK_PLAYOUTS == 0 && std::chrono::steady_clock::now() >= limits.deadline)
+        {
+            shared.stop.store(true, std::memory_order_relaxed);
+        } // end if
+
+        //
+        // Down the tree, counting every visit up front as a virtual loss.
+        Position<B> position = root;
+        int depth = 0;
+        path[0] = 0;
+        tree.node(0).visits.fetch_add(1, std::memory_order_relaxed);
+        while (!position.gameOver())
+        {
+            MctsNode &node = tree.node(path[depth]);
+            if (node.expansion.load(std::memory_order_acquire) != EXPANDED)
+            {
+                if (node.visits.load(std::memory_order_relaxed) < EXPAND_VISITS)
+                {
+                    break;
+                } // end if
+
+                expand(tree, node, position);
+                if (node.expansion.load(std::memory_order_acquire) != EXPANDED)
+                {
+                    break;
+                } // end if
+
+            } // end if
+
+            std::uint32_t child = selectChild(tree, node);
+            tree.node(child).visits.fetch_add(1, std::memory_order_relaxed);
+            position.make(tree.node(child).move);
+            path[++depth] = child;
+        } // end while
+
+        //
+        // Back up, every node scoring for the side that moved into it.
+        int winner = playout(position, random);
+        for (int step = 1; step <= depth; ++step)
+        {
+            bool moverIsX = (step % 2 == 1) == root.xMoves();
+            int reward = winner == 0 ? 1 : (winner == 1) == moverIsX ? 2 : 0;
+            tree.node(path[step]).reward.fetch_add(static_cast<std::uint32_t>(reward), std::memory_order_relaxed);
+        } // end for
+
+    } // end for
+
+} // end of function runPlayouts
+
+template <typename B>
+MctsResult monteCarloSearch(const Position<B> &root, const MctsLimits &limits, MctsTree &tree, ThreadPool *pool)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    MctsResult result;
+    tree.clear();
+    if (root.gameOver())
+    {
+        return result;
+    } // end if
+
+    std::uint64_t maxPlayouts = limits.maxPlayouts;
+    if (maxPlayouts == 0)
+    {
+        maxPlayouts = limits.deadline == std::chrono::steady_clock::time_point::max() ? DEFAULT_MCTS_PLAYOUTS : UINT64_MAX;
+    } // end if
+
+    SharedPlayouts shared;
+    if (pool != nullptr)
+    {
+        pool->parallelFor(pool->threadCount(), [&](std::size_t thread)
+                          { runPlayouts(root, limits, maxPlayouts, tree, shared, PLAYOUT_SEED * (thread + 1)); });
+    } // end if
+    else
+    {
+        runPlayouts(root, limits, maxPlayouts, tree, shared, PLAYOUT_SEED);
+    } // end else
+
+    //
+    // The most visited move is the one the search trusts most.
+    const MctsNode &rootNode = tree.node(0);
+    std::uint32_t first = rootNode.firstChild.load(std::memory_order_acquire);
+    std::uint32_t bestVisits = 0;
+    for (std::uint32_t index = first; first != 0 && index < first + rootNode.childCount; ++index)
+    {
+        const MctsNode &child = tree.node(index);
+        std::uint32_t visits = child.visits.load(std::memory_order_relaxed);
+        if (visits > bestVisits)
+        {
+            bestVisits = visits;
+            result.move = child.move;
+            result.value = child.reward.load(std::memory_order_relaxed) / (2.0 * visits);
+        } // end if
+
+    } // end for
+
+    //
+    // A tree that never grew, the pool being too small, still plays.
+    if (result.move == NO_MOVE)
+    {
+        result.move = std::countr_zero(root.legalMoves());
+    } // end if
+
+    result.playouts = std::min(shared.started.load(), maxPlayouts);
+    result.nodes = tree.nodeCount();
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+} // end of function monteCarloSearch
+
+//
+// Tree kept for each board size, one search at a time uses it
+//
+template <typename B>
+static MctsResult searchSharedTree(B board, const MctsLimits &limits, ThreadPool *pool)
+{
+    static MctsTree tree(MCTS_TREE_NODES);
+    static std::mutex treeLock;
+    std::lock_guard<std::mutex> guard(treeLock);
+    return monteCarloSearch(Position<B>(board), limits, tree, pool);
+} // end of function searchSharedTree
+
+template <typename B>
+MctsResult findBestMove(B board, const MctsLimits &limits)
+{
+    return searchSharedTree(board, limits, nullptr);
+} // end of function findBestMove
+
+template <typename B>
+MctsResult findBestMove(B board, const MctsLimits &limits, ThreadPool &pool)
+{
+    return searchSharedTree(board, limits, &pool);
+} // end of function findBestMove
+
+template MctsResult monteCarloSearch(const Position<Board> &root, const MctsLimits &limits, MctsTree &tree, ThreadPool *pool);
+template MctsResult monteCarloSearch(const Position<Board4x4> &root, const MctsLimits &limits, MctsTree &tree, ThreadPool *pool);
+template MctsResult monteCarloSearch(const Position<Board5x5> &root, const MctsLimits &limits, MctsTree &tree, ThreadPool *pool);
+template MctsResult monteCarloSearch(const Position<Board7x7> &root, const MctsLimits &limits, MctsTree &tree, ThreadPool *pool);
+
+template MctsResult findBestMove(Board board, const MctsLimits &limits);
+template MctsResult findBestMove(Board4x4 board, const MctsLimits &limits);
+template MctsResult findBestMove(Board5x5 board, const MctsLimits &limits);
+template MctsResult findBestMove(Board7x7 board, const MctsLimits &limits);
+
+template MctsResult findBestMove(Board board, const MctsLimits &limits, ThreadPool &pool);
+template MctsResult findBestMove(Board4x4 board, const MctsLimits &limits, ThreadPool &pool);
+template MctsResult findBestMove(Board5x5 board, const MctsLimits &limits, ThreadPool &pool);
+template MctsResult findBestMove(Board7x7 board, const MctsLimits &limits, ThreadPool &pool);
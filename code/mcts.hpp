@@ -0,0 +1,110 @@
+//
+// file: mcts.hpp
+// author: Michael Brockus
+// gmail: <michaelbrockus@gmail.com>
+//
+#ifndef MCTS_HPP
+#define MCTS_HPP
+
+#include "board.hpp"
+#include "position.hpp"
+#include "thread_pool.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+//
+// Budget for one tree search, stopped by whichever runs out first. With
+// neither set it stops after DEFAULT_MCTS_PLAYOUTS playouts. The clock is
+// read every MCTS_CLOCK_PLAYOUTS playouts of each thread.
+//
+struct MctsLimits
+{
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+    std::uint64_t maxPlayouts = 0;
+};
+
+const std::uint64_t DEFAULT_MCTS_PLAYOUTS = 100000;
+const std::uint64_t MCTS_CLOCK_PLAYOUTS = 64;
+
+//
+// Nodes in the tree findBestMove searches, about 16 MB
+const std::size_t MCTS_TREE_NODES = 1 << 20;
+
+//
+// Outcome of a tree search. The move is the root move tried most often and
+// value its average result for the side to move, 1 a sure win, 0.5 a draw
+// and 0 a sure loss.
+//
+struct MctsResult
+{
+    int move = NO_MOVE;
+    double value = 0.0;
+    std::uint64_t playouts = 0;
+    std::uint64_t nodes = 0;
+    double seconds = 0.0;
+
+    double playoutsPerSecond() const
+    {
+        return seconds > 0.0 ? playouts / seconds : 0.0;
+    } // end of function playoutsPerSecond
+};
+
+//
+// One position in the tree. Rewards are counted in half points for the
+// side that moved into the node, 2 for a win and 1 for a draw, and visits
+// go up on the way down, so a playout still running counts as a loss
+// (virtual loss) and steers other threads to other moves.
+//
+struct MctsNode
+{
+    std::atomic<std::uint32_t> visits{0};
+    std::atomic<std::uint32_t> reward{0};
+    std::atomic<std::uint32_t> firstChild{0};
+    std::atomic<std::uint8_t> expansion{0};
+    std::uint8_t move = 0;
+    std::uint8_t childCount = 0;
+};
+
+//
+// Fixed pool of tree nodes handed out by bumping an index, so the search
+// never allocates. The children of a node are one block. Once the pool is
+// used up the tree stops growing and the search keeps playing out from
+// its leaves.
+//
+class MctsTree
+{
+public:
+    explicit MctsTree(std::size_t capacity);
+
+    void clear();
+    std::uint32_t allocate(std::uint32_t count);
+    MctsNode &node(std::uint32_t index);
+    std::size_t capacity() const;
+    std::size_t nodeCount() const;
+
+private:
+    std::vector<MctsNode> nodes;
+    std::atomic<std::uint32_t> used{0};
+};
+
+//
+// Monte Carlo tree search with UCT selection and random playouts, on
+// every thread of the pool when one is given. Defined in mcts.cpp and
+// instantiated for Board, Board4x4, Board5x5 and Board7x7.
+//
+template <typename B>
+MctsResult monteCarloSearch(const Position<B> &root, const MctsLimits &limits, MctsTree &tree, ThreadPool *pool);
+
+//
+// Tree search alternative to the alpha-beta findBestMove for boards too
+// big to search exhaustively, using a tree kept for each board size
+//
+template <typename B>
+MctsResult findBestMove(B board, const MctsLimits &limits);
+
+template <typename B>
+MctsResult findBestMove(B board, const MctsLimits &limits, ThreadPool &pool);
+
+#endif // end of MCTS_HPP
@@ -0,0 +1,236 @@
+//
+// file: perft.cpp
+// author: Michael Brockus
+// gmail: <michaelbrockus@gmail.com>
+//
+// USE CASE:
+//
+// Exhaustive enumeration of the game tree, the way chess engines check
+// their move generators. The counts for 3x3 are known exactly, 255168
+// complete games through 5478 distinct positions, so any change to the
+// bitboards or the incremental Position has to reproduce them, and on
+// the bigger boards the walk measures raw move generation speed.
+//
+#include "perft.hpp"
+#include "position.hpp"
+#include <algorithm>
+
+//
+// Unmerged walks are split into independent subtrees once there are this
+// many per thread
+const std::size_t PERFT_TASKS_PER_THREAD = 64;
+
+template <typename B>
+struct PerftNode
+{
+    std::uint64_t key = 0;
+    B board;
+    std::uint64_t count = 0;
+};
+
+//
+// Count a finished game count times, false when the game goes on
+//
+template <typename B>
+static bool countEnd(const Position<B> &position, PerftLevel &level, std::uint64_t count)
+{
+    if (!position.gameOver())
+    {
+        return false;
+    } // end if
+
+    int state = position.state();
+    if (state == static_cast<int>(State::DRAW))
+    {
+        level.draws += count;
+    } // end if
+    else if ((state == static_cast<int>(State::WIN)) == position.xMoves())
+    {
+        level.xWins += count;
+    } // end else if
+    else
+    {
+        level.oWins += count;
+    } // end else
+    return true;
+} // end of function countEnd
+
+static void addLevels(std::vector<PerftLevel> &total, const std::vector<PerftLevel> &part)
+{
+    for (std::size_t ply = 0; ply < total.size(); ++ply)
+    {
+        total[ply].nodes += part[ply].nodes;
+        total[ply].xWins += part[ply].xWins;
+        total[ply].oWins += part[ply].oWins;
+        total[ply].draws += part[ply].draws;
+        total[ply].positions += part[ply].positions;
+    } // end for
+
+} // end of function addLevels
+
+//
+// Depth first walk below one node, make and unmake on a single position
+//
+template <typename B>
+static void walk(Position<B> &position, int ply, int depth, std::vector<PerftLevel> &levels)
+{
+    ++levels[ply].nodes;
+    if (countEnd(position, levels[ply], 1) || ply == depth)
+    {
+        return;
+    } // end if
+
+    for (typename B::Mask moves = position.legalMoves(); moves != 0; moves &= moves - 1)
+    {
+        int cell = std::countr_zero(moves);
+        position.make(cell);
+        walk(position, ply + 1, depth, levels);
+        position.unmake(cell);
+    } // end for
+
+} // end of function walk
+
+//
+// Children of every unfinished node, one entry per move
+//
+template <typename B>
+static void expandNodes(const PerftNode<B> *first, const PerftNode<B> *last, std::vector<PerftNode<B>> &children)
+{
+    for (const PerftNode<B> *node = first; node != last; ++node)
+    {
+        Position<B> position(node->board);
+        if (position.gameOver())
+        {
+            continue;
+        } // end if
+
+        for (typename B::Mask moves = position.legalMoves(); moves != 0; moves &= moves - 1)
+        {
+            int cell = std::countr_zero(moves);
+            position.make(cell);
+            children.push_back(PerftNode<B>{position.hash(), position.board(), node->count});
+            position.unmake(cell);
+        } // end for
+
+    } // end for
+
+} // end of function expandNodes
+
+//
+// Count one ply kept as a list of nodes
+//
+template <typename B>
+static void countLevel(const std::vector<PerftNode<B>> &nodes, PerftLevel &level, bool merged)
+{
+    for (const PerftNode<B> &node : nodes)
+    {
+        level.nodes += node.count;
+        countEnd(Position<B>(node.board), level, node.count);
+    } // end for
+    level.positions = merged ? nodes.size() : 0;
+} // end of function countLevel
+
+//
+// Fold nodes with the same board into one carrying their summed count
+//
+template <typename B>
+static void mergeNodes(std::vector<PerftNode<B>> &nodes)
+{
+    std::sort(nodes.begin(), nodes.end(), [](const PerftNode<B> &left, const PerftNode<B> &right)
+              { return left.key < right.key; });
+    std::size_t kept = 0;
+    for (std::size_t index = 0; index < nodes.size(); ++index)
+    {
+        if (kept > 0 && nodes[kept - 1].key == nodes[index].key)
+        {
+            nodes[kept - 1].count += nodes[index].count;
+        } // end if
+        else
+        {
+            nodes[kept++] = nodes[index];
+        } // end else
+
+    } // end for
+    nodes.resize(kept);
+} // end of function mergeNodes
+
+//
+// Expand a whole ply on the pool, slice by slice
+//
+template <typename B>
+static std::vector<PerftNode<B>> expandLevel(const std::vector<PerftNode<B>> &nodes, ThreadPool &pool)
+{
+    std::size_t sliceCount = std::max<std::size_t>(1, std::min(nodes.size(), pool.threadCount() * PERFT_TASKS_PER_THREAD));
+    std::vector<std::vector<PerftNode<B>>> slices(sliceCount);
+    pool.parallelFor(sliceCount, [&](std::size_t slice)
+                     {
+        std::size_t first = nodes.size() * slice / sliceCount;
+        std::size_t last = nodes.size() * (slice + 1) / sliceCount;
+        expandNodes(nodes.data() + first, nodes.data() + last, slices[slice]); });
+
+    std::vector<PerftNode<B>> children;
+    for (const std::vector<PerftNode<B>> &slice : slices)
+    {
+        children.insert(children.end(), slice.begin(), slice.end());
+    } // end for
+    return children;
+} // end of function expandLevel
+
+template <typename B>
+std::vector<PerftLevel> perft(B start, int depth, ThreadPool &pool, bool merge)
+{
+    depth = std::max(depth, 0);
+    std::vector<PerftLevel> levels(static_cast<std::size_t>(depth) + 1);
+    std::vector<PerftNode<B>> nodes{PerftNode<B>{Position<B>(start).hash(), start, 1}};
+
+    //
+    // Merged, every ply goes breadth first. Unmerged, only until there is
+    // enough to keep every thread busy, the rest is walked depth first.
+    int ply = 0;
+    for (;; ++ply)
+    {
+        if (merge)
+        {
+            mergeNodes(nodes);
+        } // end if
+
+        countLevel(nodes, levels[ply], merge);
+        if (ply == depth || nodes.empty() || (!merge && nodes.size() >= pool.threadCount() * PERFT_TASKS_PER_THREAD))
+        {
+            break;
+        } // end if
+        nodes = expandLevel(nodes, pool);
+    } // end for
+
+    if (merge || ply == depth)
+    {
+        return levels;
+    } // end if
+
+    std::vector<std::vector<PerftLevel>> parts(nodes.size(), std::vector<PerftLevel>(levels.size()));
+    pool.parallelFor(nodes.size(), [&](std::size_t index)
+                     {
+        Position<B> position(nodes[index].board);
+        if (!position.gameOver())
+        {
+            for (typename B::Mask moves = position.legalMoves(); moves != 0; moves &= moves - 1)
+            {
+                int cell = std::countr_zero(moves);
+                position.make(cell);
+                walk(position, ply + 1, depth, parts[index]);
+                position.unmake(cell);
+            } // end for
+        } // end if
+    });
+
+    for (const std::vector<PerftLevel> &part : parts)
+    {
+        addLevels(levels, part);
+    } // end for
+    return levels;
+} // end of function perft
+
+template std::vector<PerftLevel> perft(Board start, int depth, ThreadPool &pool, bool merge);
+template std::vector<PerftLevel> perft(Board4x4 start, int depth, ThreadPool &pool, bool merge);
+template std::vector<PerftLevel> perft(Board5x5 start, int depth, ThreadPool &pool, bool merge);
+template std::vector<PerftLevel> perft(Board7x7 start, int depth, ThreadPool &pool, bool merge);
@@ -0,0 +1,41 @@
+//
+// file: perft.hpp
+// author: Michael Brockus
+// gmail: <michaelbrockus@gmail.com>
+//
+#ifndef PERFT_HPP
+#define PERFT_HPP
+
+#include "board.hpp"
+#include "thread_pool.hpp"
+#include <cstdint>
+#include <vector>
+
+//
+// Census of the game tree at one ply from the start. Nodes count every
+// move sequence reaching the ply, the wins and draws the games that end
+// there and positions the distinct boards among the nodes, 0 unless the
+// walk merges them.
+//
+struct PerftLevel
+{
+    std::uint64_t nodes = 0;
+    std::uint64_t xWins = 0;
+    std::uint64_t oWins = 0;
+    std::uint64_t draws = 0;
+    std::uint64_t positions = 0;
+};
+
+//
+// Walk every game from start for depth plies on the pool, one PerftLevel
+// per ply from 0 to depth, the side to move following from the mark
+// count. Unmerged, every node is visited. Merged, each ply is kept as its
+// distinct boards, keyed by Zobrist hash, with how many move sequences
+// reach each one, which counts positions and saves the work of walking
+// the same board twice. Defined in perft.cpp for Board, Board4x4,
+// Board5x5 and Board7x7.
+//
+template <typename B>
+std::vector<PerftLevel> perft(B start, int depth, ThreadPool &pool, bool merge);
+
+#endif // end of PERFT_HPP
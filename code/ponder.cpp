@@ -0,0 +1,154 @@
+//
+// file: ponder.cpp
+// author: Michael Brockus
+// gmail: <michaelbrockus@gmail.com>
+//
+// USE CASE:
+//
+// Searches that run beside the caller. An interactive game spends most
+// of its time waiting for the player, and on the bigger boards the
+// engine's move is where the waiting is felt. Searching while the player
+// thinks fills the engine's table with the answers to every reply, so
+// the search after the real move mostly reads them back.
+//
+#include "ponder.hpp"
+#include <chrono>
+#include <type_traits>
+
+SearchTask &SearchTask::operator=(SearchTask &&other)
+{
+    if (this != &other)
+    {
+        cancel();
+        if (result.valid())
+        {
+            result.wait();
+        } // end if
+        stop = std::move(other.stop);
+        result = std::move(other.result);
+    } // end if
+    return *this;
+} // end of function operator=
+
+SearchTask::~SearchTask()
+{
+    cancel();
+} // end of destructor
+
+void SearchTask::cancel()
+{
+    if (stop != nullptr)
+    {
+        stop->store(true, std::memory_order_relaxed);
+    } // end if
+
+} // end of function cancel
+
+//
+// Whether the task has a result not yet waited for
+//
+bool SearchTask::running() const
+{
+    return result.valid();
+} // end of function running
+
+//
+// Whether wait would return at once
+//
+bool SearchTask::ready() const
+{
+    return result.valid() && result.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+} // end of function ready
+
+SearchResult SearchTask::wait()
+{
+    return result.valid() ? result.get() : SearchResult{};
+} // end of function wait
+
+template <typename B>
+SearchTask startSearch(B board, SearchLimits limits, ThreadPool *pool)
+{
+    SearchTask task;
+    task.stop = std::make_shared<std::atomic<bool>>(false);
+    limits.stop = task.stop.get();
+    task.result = std::async(std::launch::async, [board, limits, pool]()
+                             { return pool != nullptr ? findBestMove(board, limits, *pool) : findBestMove(board, limits); });
+    return task;
+} // end of function startSearch
+
+template <typename B>
+SearchTask startSearch(Engine<B> &engine, SearchLimits limits)
+{
+    SearchTask task;
+    task.stop = std::make_shared<std::atomic<bool>>(false);
+    limits.stop = task.stop.get();
+    task.result = std::async(std::launch::async, [&engine, limits]()
+                             { return engine.think(limits); });
+    return task;
+} // end of function startSearch
+
+template <typename B>
+Ponderer<B>::Ponderer(Engine<B> &engine) : engine(engine)
+{
+} // end of constructor
+
+template <typename B>
+Ponderer<B>::~Ponderer()
+{
+    stop();
+} // end of destructor
+
+//
+// Start thinking on the board the opponent has to move in, nothing to do
+// once the game is over or on the 3x3 board, whose answers are looked up
+//
+template <typename B>
+void Ponderer<B>::ponder(B board)
+{
+    stop();
+    if (std::is_same_v<B, Board> || boardState(board, xToMove(board)) != static_cast<int>(State::DRAW) || boardFull(board))
+    {
+        return;
+    } // end if
+    engine.setBoard(board);
+    task = startSearch(engine, SearchLimits{});
+} // end of function ponder
+
+template <typename B>
+SearchResult Ponderer<B>::respond(B board, const SearchLimits &limits)
+{
+    stop();
+    engine.setBoard(board);
+    return engine.think(limits);
+} // end of function respond
+
+//
+// Cancel the pondering and wait for it to unwind
+//
+template <typename B>
+void Ponderer<B>::stop()
+{
+    task.cancel();
+    task.wait();
+} // end of function stop
+
+template <typename B>
+bool Ponderer<B>::pondering() const
+{
+    return task.running() && !task.ready();
+} // end of function pondering
+
+template SearchTask startSearch(Board board, SearchLimits limits, ThreadPool *pool);
+template SearchTask startSearch(Board4x4 board, SearchLimits limits, ThreadPool *pool);
+template SearchTask startSearch(Board5x5 board, SearchLimits limits, ThreadPool *pool);
+template SearchTask startSearch(Board7x7 board, SearchLimits limits, ThreadPool *pool);
+
+template SearchTask startSearch(Engine<Board> &engine, SearchLimits limits);
+template SearchTask startSearch(Engine<Board4x4> &engine, SearchLimits limits);
+template SearchTask startSearch(Engine<Board5x5> &engine, SearchLimits limits);
+template SearchTask startSearch(Engine<Board7x7> &engine, SearchLimits limits);
+
+template class Ponderer<Board>;
+template class Ponderer<Board4x4>;
+template class Ponderer<Board5x5>;
+template class Ponderer<Board7x7>;
@@ -0,0 +1,91 @@
+//
+// file: ponder.hpp
+// author: Michael Brockus
+// gmail: <michaelbrockus@gmail.com>
+//
+#ifndef PONDER_HPP
+#define PONDER_HPP
+
+#include "engine.hpp"
+#include <atomic>
+#include <future>
+#include <memory>
+
+class SearchTask;
+
+//
+// Start findBestMove for the board and return at once. The limits keep
+// their deadline and budgets, their stop flag is replaced by the task's
+// own. With a pool the search uses it, and nothing else may use the pool
+// until the task is done.
+//
+template <typename B>
+SearchTask startSearch(B board, SearchLimits limits, ThreadPool *pool = nullptr);
+
+//
+// A findBestMove running on a thread of its own. cancel asks it to stop,
+// wait blocks until it has and hands over the result, which comes from
+// the last depth finished like any search cut short. A task is waited on
+// at most once, and dropping one that is still running blocks until the
+// search notices it was cancelled.
+//
+class SearchTask
+{
+public:
+    SearchTask() = default;
+    SearchTask(SearchTask &&) = default;
+    SearchTask &operator=(SearchTask &&other);
+    ~SearchTask();
+
+    void cancel();
+    bool running() const;
+    bool ready() const;
+    SearchResult wait();
+
+private:
+    template <typename B>
+    friend SearchTask startSearch(B board, SearchLimits limits, ThreadPool *pool);
+
+    template <typename B>
+    friend SearchTask startSearch(Engine<B> &engine, SearchLimits limits);
+
+    std::shared_ptr<std::atomic<bool>> stop;
+    std::future<SearchResult> result;
+};
+
+//
+// Start the engine thinking about its current position and return at
+// once, the engine left alone until the task is done
+//
+template <typename B>
+SearchTask startSearch(Engine<B> &engine, SearchLimits limits);
+
+//
+// Thinking on the opponent's time. Once the engine has moved, ponder has
+// it search the board the opponent now faces with no budget, which walks
+// every reply and leaves their values in the engine's table. respond
+// cancels that search when the real move comes in and has the engine
+// think about it, starting from what the pondering already proved. The
+// 3x3 board is answered from the solved table and never pondered.
+//
+template <typename B>
+class Ponderer
+{
+public:
+    explicit Ponderer(Engine<B> &engine);
+    ~Ponderer();
+
+    Ponderer(const Ponderer &) = delete;
+    Ponderer &operator=(const Ponderer &) = delete;
+
+    void ponder(B board);
+    SearchResult respond(B board, const SearchLimits &limits);
+    void stop();
+    bool pondering() const;
+
+private:
+    Engine<B> &engine;
+    SearchTask task;
+};
+
+#endif // end of PONDER_HPP
@@ -0,0 +1,224 @@
+//
+// file: position.hpp
+// author: Michael Brockus
+// gmail: <michaelbrockus@gmail.com>
+//
+#ifndef POSITION_HPP
+#define POSITION_HPP
+
+#include "board.hpp"
+#include <array>
+#include <cstdint>
+
+//
+// Winning lines through every cell of a board, by index into B::LINES
+//
+template <typename B>
+struct CellLines
+{
+    std::array<std::array<std::uint8_t, 4 * B::IN_A_ROW>, B::CELLS> lines{};
+    std::array<std::uint8_t, B::CELLS> count{};
+};
+
+template <typename B>
+constexpr CellLines<B> makeCellLines()
+{
+    static_assert(B::LINE_COUNT <= 256, "line indices are stored in a byte");
+    CellLines<B> table;
+    for (int line = 0; line < B::LINE_COUNT; ++line)
+    {
+        for (int cell = 0; cell < B::CELLS; ++cell)
+        {
+            if (B::LINES[line] & B::cellMask(cell))
+            {
+                table.lines[cell][table.count[cell]++] = static_cast<std::uint8_t>(line);
+            } // end if
+
+        } // end for
+
+    } // end for
+
+    return table;
+} // end of function makeCellLines
+
+template <typename B>
+inline constexpr CellLines<B> CELL_LINES = makeCellLines<B>();
+
+//
+// Moves of one node, sized for the board so it lives on the stack
+//
+template <typename B>
+class MoveList
+{
+public:
+    constexpr void push(int cell)
+    {
+        cells[length++] = static_cast<std::uint8_t>(cell);
+    } // end of function push
+
+    constexpr int size() const
+    {
+        return length;
+    } // end of function size
+
+    constexpr int operator[](int index) const
+    {
+        return cells[index];
+    } // end of function operator[]
+
+private:
+    std::array<std::uint8_t, B::CELLS> cells{};
+    int length = 0;
+};
+
+//
+// Folded into the hash whenever O is to move
+const std::uint64_t ZOBRIST_O_TO_MOVE = 0xD6E8FEB86659FD93ull;
+
+//
+// A board together with everything the search asks about it at every
+// node, kept up to date one move at a time: the side to move, how many
+// marks each side has on every line, how many lines each side completed,
+// the number of empty cells and the Zobrist hash. The side to move is
+// stored, not guessed from the mark count, so any start position works.
+// make() and unmake() have to be paired, unmake taking the last move made.
+//
+template <typename B>
+class Position
+{
+public:
+    using Mask = typename B::Mask;
+
+    constexpr Position() : Position(B{}, true)
+    {
+    } // end of constructor
+
+    constexpr explicit Position(B board) : Position(board, xToMove(board))
+    {
+    } // end of constructor
+
+    constexpr Position(B board, bool xMoves) : current(board), xSide(xMoves)
+    {
+        emptyCells = B::CELLS - std::popcount(occupiedCells(board));
+        hashKey = zobristKey(board) ^ (xMoves ? 0 : ZOBRIST_O_TO_MOVE);
+        for (int line = 0; line < B::LINE_COUNT; ++line)
+        {
+            for (int side = 0; side < 2; ++side)
+            {
+                Mask marks = side == 0 ? board.x : board.o;
+                lineMarks[side][line] = static_cast<std::uint8_t>(std::popcount(static_cast<Mask>(marks & B::LINES[line])));
+                completed[side] += lineMarks[side][line] == B::IN_A_ROW;
+            } // end for
+
+        } // end for
+    } // end of constructor
+
+    constexpr const B &board() const
+    {
+        return current;
+    } // end of function board
+
+    constexpr bool xMoves() const
+    {
+        return xSide;
+    } // end of function xMoves
+
+    constexpr std::uint64_t hash() const
+    {
+        return hashKey;
+    } // end of function hash
+
+    constexpr int emptyCount() const
+    {
+        return emptyCells;
+    } // end of function emptyCount
+
+    constexpr Mask legalMoves() const
+    {
+        return legalMoveMask(current);
+    } // end of function legalMoves
+
+    constexpr int lineCount(bool forX, int line) const
+    {
+        return lineMarks[forX ? 0 : 1][line];
+    } // end of function lineCount
+
+    constexpr bool gameOver() const
+    {
+        return emptyCells == 0 || completed[0] != 0 || completed[1] != 0;
+    } // end of function gameOver
+
+    //
+    // Same as boardState(board(), xMoves())
+    //
+    constexpr int state() const
+    {
+        if (completed[xSide ? 0 : 1] != 0)
+        {
+            return static_cast<int>(State::WIN);
+        } // end if
+
+        if (completed[xSide ? 1 : 0] != 0)
+        {
+            return static_cast<int>(State::LOSS);
+        } // end if
+
+        return static_cast<int>(State::DRAW);
+    } // end of function state
+
+    constexpr void make(int cell)
+    {
+        int side = xSide ? 0 : 1;
+        if (xSide)
+        {
+            current.x |= B::cellMask(cell);
+        } // end if
+        else
+        {
+            current.o |= B::cellMask(cell);
+        } // end else
+
+        for (int index = 0; index < CELL_LINES<B>.count[cell]; ++index)
+        {
+            int line = CELL_LINES<B>.lines[cell][index];
+            completed[side] += ++lineMarks[side][line] == B::IN_A_ROW;
+        } // end for
+
+        hashKey ^= ZOBRIST_KEYS[side][cell] ^ ZOBRIST_O_TO_MOVE;
+        --emptyCells;
+        xSide = !xSide;
+    } // end of function make
+
+    constexpr void unmake(int cell)
+    {
+        xSide = !xSide;
+        int side = xSide ? 0 : 1;
+        if (xSide)
+        {
+            current.x &= static_cast<Mask>(~B::cellMask(cell));
+        } // end if
+        else
+        {
+            current.o &= static_cast<Mask>(~B::cellMask(cell));
+        } // end else
+
+        for (int index = 0; index < CELL_LINES<B>.count[cell]; ++index)
+        {
+            int line = CELL_LINES<B>.lines[cell][index];
+            completed[side] -= lineMarks[side][line]-- == B::IN_A_ROW;
+        } // end for
+
+        hashKey ^= ZOBRIST_KEYS[side][cell] ^ ZOBRIST_O_TO_MOVE;
+        ++emptyCells;
+    } // end of function unmake
+
+private:
+    B current;
+    bool xSide = true;
+    int emptyCells = B::CELLS;
+    std::uint64_t hashKey = 0;
+    std::array<int, 2> completed{};
+    std::array<std::array<std::uint8_t, B::LINE_COUNT>, 2> lineMarks{};
+};
+
+#endif // end of POSITION_HPP
@@ -5,6 +5,7 @@
 //
 #include "program.hpp"
 #include "game.hpp"
+#include "ponder.hpp"
 #include <iostream>
 #include <cstdlib>
 
@@ -24,8 +25,14 @@ int foundation(void)
     std::cout << "Player = X\t Dodo = O" << std::endl
               << std::endl;
 
+    //
+    // The 3x3 engine answers from the solved table, so it neither needs a
+    // search table nor ponders, the same loop on a bigger board would
+    Engine<Board> engine(TABLE_SLOT_BYTES);
+    Ponderer<Board> ponderer(engine);
     while (!gameIsDone(board))
     {
+        ponderer.ponder(toBoard(board));
         int row, col;
         std::cout << "Row play: ";
         std::cin >> row;
@@ -44,8 +51,11 @@ int foundation(void)
             board[row][col] = PLAYER_MARKER;
         } // end else
 
-        std::pair<int, int> aiMove = findBestMove(board);
-        board[aiMove.first][aiMove.second] = AI_MARKER;
+        SearchResult reply = ponderer.respond(toBoard(board), SearchLimits{});
+        if (reply.move != NO_MOVE)
+        {
+            board[reply.move / 3][reply.move % 3] = AI_MARKER;
+        } // end if
 
         printBoard(board);
     } // end while
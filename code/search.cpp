@@ -0,0 +1,797 @@
+//
+// file: search.cpp
+// author: Michael Brockus
+// gmail: <michaelbrockus@gmail.com>
+//
+#include "search.hpp"
+#include "book.hpp"
+#include "position.hpp"
+#include "simd_kernel.hpp"
+#include "symmetry.hpp"
+#include "tablebase.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+//
+// Results of every search done by this process, kept between calls
+// since the same positions come up game after game. The 3x3 board gets
+// a perfect table, one slot per board and side to move, bigger boards a
+// hashed one.
+//
+template <typename B>
+TranspositionTable &sharedSearchTable()
+{
+    static TranspositionTable table(std::is_same_v<B, Board> ? 2 * POSITION_COUNT : LARGE_TABLE_ENTRIES);
+    return table;
+} // end of function sharedSearchTable
+
+//
+// Where a position lives in the transposition table. The 3x3 board is
+// folded onto its canonical orientation so all 8 symmetric boards share
+// one entry, bigger boards use the incremental Zobrist hash. Both include
+// the side to move.
+//
+struct TableKey
+{
+    std::uint64_t key = 0;
+    int symmetry = 0;
+};
+
+template <typename B>
+static TableKey tableKey(const Position<B> &position)
+{
+    if constexpr (std::is_same_v<B, Board>)
+    {
+        CanonicalBoard canonical = canonicalize(position.board());
+        return TableKey{2u * positionKey(canonical.board) + (position.xMoves() ? 0u : 1u), canonical.symmetry};
+    } // end if
+    else
+    {
+        return TableKey{position.hash(), 0};
+    } // end else
+} // end of function tableKey
+
+static int moveFromTable(int move, const TableKey &key)
+{
+    return key.symmetry == 0 ? move : moveFromCanonical(move, key.symmetry);
+} // end of function moveFromTable
+
+static int moveToTable(int move, const TableKey &key)
+{
+    return key.symmetry == 0 ? move : moveToCanonical(move, key.symmetry);
+} // end of function moveToTable
+
+//
+// The search counts won and lost scores from the root, the table from
+// the position itself, so an entry holds wherever the position comes up
+//
+static int scoreToTable(int score, int ply)
+{
+    if (score >= HEURISTIC_LIMIT)
+    {
+        return score + ply;
+    } // end if
+    else if (score <= -HEURISTIC_LIMIT)
+    {
+        return score - ply;
+    } // end else if
+
+    return score;
+} // end of function scoreToTable
+
+static int scoreFromTable(int score, int ply)
+{
+    if (score >= HEURISTIC_LIMIT)
+    {
+        return score - ply;
+    } // end if
+    else if (score <= -HEURISTIC_LIMIT)
+    {
+        return score + ply;
+    } // end else if
+
+    return score;
+} // end of function scoreFromTable
+
+//
+// Start a line with the move, followed by the line of the reply
+//
+static void extendLine(MoveLine &line, int move, const MoveLine &reply)
+{
+    line.moves[0] = static_cast<std::int8_t>(move);
+    std::copy_n(reply.moves.begin(), reply.length, line.moves.begin() + 1);
+    line.length = reply.length + 1;
+} // end of function extendLine
+
+//
+// State shared by the threads of one parallel search
+//
+struct SharedSearch
+{
+    std::atomic<bool> stop{false};
+    std::atomic<std::uint64_t> nodes{0};
+};
+
+//
+// State shared by every node of one search on one thread, ply is how far
+// the current node is from the root
+//
+struct SearchContext
+{
+    TranspositionTable &table;
+    const SearchLimits &limits;
+    SharedSearch *shared = nullptr;
+    std::uint64_t nodes = 0;
+    std::uint64_t flushedNodes = 0;
+    bool aborted = false;
+    int ply = 0;
+    SearchStats stats;
+};
+
+//
+// Check the node and time budgets and the stop flag, once blown the
+// search unwinds. Threads of a parallel search publish their node counts
+// every DEADLINE_CHECK_NODES nodes, so together they can overrun a node
+// budget by that much each.
+//
+static bool outOfBudget(SearchContext &context)
+{
+    std::uint64_t totalNodes = context.nodes;
+    if (context.shared != nullptr)
+    {
+        totalNodes += context.shared->nodes.load(std::memory_order_relaxed) - context.flushedNodes;
+    } // end if
+
+    if (context.limits.maxNodes != 0 && totalNodes >= context.limits.maxNodes)
+    {
+        context.aborted = true;
+    } // end if
+    else if (context.nodes % DEADLINE_CHECK_NODES == 0)
+    {
+        if (context.shared != nullptr)
+        {
+            context.shared->nodes.fetch_add(context.nodes - context.flushedNodes, std::memory_order_relaxed);
+            context.flushedNodes = context.nodes;
+            context.aborted = context.shared->stop.load(std::memory_order_relaxed);
+        } // end if
+
+        if (std::chrono::steady_clock::now() >= context.limits.deadline ||
+            (context.limits.stop != nullptr && context.limits.stop->load(std::memory_order_relaxed)))
+        {
+            context.aborted = true;
+        } // end if
+
+    } // end else if
+
+    if (context.aborted && context.shared != nullptr)
+    {
+        context.shared->stop.store(true, std::memory_order_relaxed);
+    } // end if
+
+    return context.aborted;
+} // end of function outOfBudget
+
+#if TTD_WITH_STATS
+//
+// Close the stats of a top level search and add them to the process totals
+//
+static void finishStats(SearchContext &context, std::chrono::steady_clock::time_point start, SearchResult &result)
+{
+    context.stats.calls = 1;
+    context.stats.nodes = context.nodes;
+    context.stats.wallNanos = nanosSince(start);
+    result.stats = context.stats;
+    recordSearch(context.stats);
+} // end of function finishStats
+#endif
+
+//
+// Static score of a position the search did not finish, from the point of
+// view of the side given. Every line still open for one side only counts
+// for that side, four times more for every mark already on it.
+//
+template <typename B>
+int evaluateBoard(B board, bool forX)
+{
+    typename B::Mask own = forX ? board.x : board.o;
+    typename B::Mask opponent = forX ? board.o : board.x;
+    int score = 0;
+    for (typename B::Mask line : B::LINES)
+    {
+        int ownCount = std::popcount(static_cast<typename B::Mask>(line & own));
+        int opponentCount = std::popcount(static_cast<typename B::Mask>(line & opponent));
+        if (opponentCount == 0)
+        {
+            score += 1 << (2 * ownCount);
+        } // end if
+        else if (ownCount == 0)
+        {
+            score -= 1 << (2 * opponentCount);
+        } // end else if
+
+    } // end for
+
+    return std::clamp(score, 1 - HEURISTIC_LIMIT, HEURISTIC_LIMIT - 1);
+} // end of function evaluateBoard
+
+//
+// evaluateBoard for the side to move, read off the line counts the
+// position already keeps
+//
+template <typename B>
+static int evaluatePosition(const Position<B> &position)
+{
+    bool forX = position.xMoves();
+    int score = 0;
+    for (int line = 0; line < B::LINE_COUNT; ++line)
+    {
+        int ownCount = position.lineCount(forX, line);
+        int opponentCount = position.lineCount(!forX, line);
+        if (opponentCount == 0)
+        {
+            score += 1 << (2 * ownCount);
+        } // end if
+        else if (ownCount == 0)
+        {
+            score -= 1 << (2 * opponentCount);
+        } // end else if
+
+    } // end for
+
+    return std::clamp(score, 1 - HEURISTIC_LIMIT, HEURISTIC_LIMIT - 1);
+} // end of function evaluatePosition
+
+//
+// Try the cached best move first, then the rest in B::MOVE_ORDER.
+//
+template <typename B>
+static void orderMoves(typename B::Mask legalMoves, int tableMove, MoveList<B> &moves)
+{
+    if (tableMove != NO_MOVE && (legalMoves & B::cellMask(tableMove)))
+    {
+        moves.push(tableMove);
+    } // end if
+    for (int cell : B::MOVE_ORDER)
+    {
+        if (cell != tableMove && (legalMoves & B::cellMask(cell)))
+        {
+            moves.push(cell);
+        } // end if
+
+    } // end for
+
+} // end of function orderMoves
+
+//
+// Negamax alpha-beta to the given depth, the score is from the point of
+// view of the side to move. line gets the best move followed by the
+// expected replies, it is empty when the node was cut off without a move.
+//
+template <typename B>
+static int alphaBeta(Position<B> &position, int depth, int alpha, int beta, SearchContext &context, MoveLine &line)
+{
+    ++context.nodes;
+    TTD_STAT(context.stats.maxDepth = std::max(context.stats.maxDepth, context.ply));
+    line.length = 0;
+    if (outOfBudget(context))
+    {
+        return 0;
+    } // end if
+
+    //
+    // If we have no more moves to make then return a WIN, LOSE or DRAW
+    // value, a win or loss counted from the root.
+    if (position.gameOver())
+    {
+        TTD_STAT(++context.stats.leaves);
+        int state = position.state();
+        return state > 0 ? state - context.ply : state < 0 ? state + context.ply : state;
+    } // end if
+
+    if (depth <= 0)
+    {
+        TTD_STAT(++context.stats.leaves);
+        return evaluatePosition(position);
+    } // end if
+
+    //
+    // Mate distance pruning: nothing here beats a win on the next move or
+    // loses faster than right now, so a window outside that is settled.
+    alpha = std::max(alpha, static_cast<int>(State::LOSS) + context.ply);
+    beta = std::min(beta, static_cast<int>(State::WIN) - context.ply - 1);
+    if (alpha >= beta)
+    {
+        TTD_STAT(++context.stats.cutoffs);
+        return alpha;
+    } // end if
+
+    //
+    // A stored bound from a deep enough search may be enough to answer
+    // without searching, a shallower one still gives the move to try first.
+    TableKey key = tableKey(position);
+    int tableMove = NO_MOVE;
+    TableEntry entry;
+    TTD_STAT(++context.stats.tableProbes);
+    if (context.table.probe(key.key, entry))
+    {
+        TTD_STAT(++context.stats.tableHits);
+        tableMove = moveFromTable(entry.bestMove, key);
+        int tableScore = scoreFromTable(entry.score, context.ply);
+        if (entry.depth >= depth)
+        {
+            if (entry.bound == Bound::EXACT)
+            {
+                extendLine(line, tableMove, MoveLine{});
+                return tableScore;
+            } // end if
+            else if (entry.bound == Bound::LOWER)
+            {
+                alpha = std::max(alpha, tableScore);
+            } // end else if
+            else
+            {
+                beta = std::min(beta, tableScore);
+            } // end else
+
+            if (alpha >= beta)
+            {
+                extendLine(line, tableMove, MoveLine{});
+                return tableScore;
+            } // end if
+
+        } // end if
+
+    } // end if
+
+    MoveList<B> moves;
+    orderMoves<B>(position.legalMoves(), tableMove, moves);
+
+    int originalAlpha = alpha;
+    int bestScore = INT32_MIN;
+    MoveLine reply;
+    for (int index = 0; index < moves.size(); ++index)
+    {
+        ++context.ply;
+        position.make(moves[index]);
+        int newScore = -alphaBeta(position, depth - 1, -beta, -alpha, context, reply);
+        position.unmake(moves[index]);
+        --context.ply;
+
+        //
+        // An unfinished subtree says nothing, leave the table alone.
+        if (context.aborted)
+        {
+            return 0;
+        } // end if
+
+        if (newScore > bestScore)
+        {
+            bestScore = newScore;
+            extendLine(line, moves[index], reply);
+        } // end if
+
+        alpha = std::max(alpha, bestScore);
+        if (alpha >= beta)
+        {
+            TTD_STAT(++context.stats.cutoffs);
+            break;
+        } // end if
+
+    } // end for
+
+    Bound bound = Bound::EXACT;
+    if (bestScore <= originalAlpha)
+    {
+        bound = Bound::UPPER;
+    } // end if
+    else if (bestScore >= beta)
+    {
+        bound = Bound::LOWER;
+    } // end else if
+
+    context.table.store(key.key, scoreToTable(bestScore, context.ply), moveToTable(line.moves[0], key), bound, depth);
+    return bestScore;
+} // end of function alphaBeta
+
+//
+// Carry a line past where the search left it, often a table hit, by
+// following the best moves in the table until the game is over or the
+// line is maxLength moves long
+//
+template <typename B>
+static void completeLine(const Position<B> &root, TranspositionTable &table, int maxLength, MoveLine &line)
+{
+    Position<B> position = root;
+    for (int index = 0; index < line.length; ++index)
+    {
+        position.make(line.moves[index]);
+    } // end for
+
+    TableEntry entry;
+    while (line.length < maxLength && !position.gameOver())
+    {
+        TableKey key = tableKey(position);
+        if (!table.probe(key.key, entry))
+        {
+            break;
+        } // end if
+
+        int move = moveFromTable(entry.bestMove, key);
+        if (move == NO_MOVE || (position.legalMoves() & B::cellMask(move)) == 0)
+        {
+            break;
+        } // end if
+
+        line.moves[line.length++] = static_cast<std::int8_t>(move);
+        position.make(move);
+    } // end while
+
+} // end of function completeLine
+
+//
+// Search the board to the end of the game with a window just wide enough
+// for every possible score, so the result at the root is always exact.
+//
+template <typename B>
+SearchResult alphaBetaSearch(const Position<B> &root, TranspositionTable &table)
+{
+    TTD_STAT(std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now());
+    SearchLimits limits;
+    SearchContext context{table, limits};
+    SearchResult result;
+    Position<B> position = root;
+    result.depth = position.emptyCount();
+    result.score = alphaBeta(position, result.depth,
+                             static_cast<int>(State::LOSS) - 1,
+                             static_cast<int>(State::WIN) + 1,
+                             context, result.line);
+    completeLine(root, table, B::CELLS, result.line);
+    result.move = result.line.length > 0 ? result.line.moves[0] : NO_MOVE;
+    result.nodes = context.nodes;
+    TTD_STAT(finishStats(context, start, result));
+    return result;
+} // end of function alphaBetaSearch
+
+template <typename B>
+SearchResult alphaBetaSearch(B board, TranspositionTable &table)
+{
+    return alphaBetaSearch(Position<B>(board), table);
+} // end of function alphaBetaSearch
+
+//
+// Root of a parallel search, young brothers wait: the first move is
+// searched alone to set alpha, then the younger brothers are spread over
+// the pool, each starting from the best alpha known when it starts. Ties
+// go to the move earlier in the ordering, and with a single thread the
+// moves run in order, so the result matches the serial search exactly.
+//
+template <typename B>
+static int parallelRoot(const Position<B> &root, int depth, SearchContext &context, ThreadPool &pool, MoveLine &line)
+{
+    TableKey key = tableKey(root);
+    TableEntry entry;
+    TTD_STAT(++context.stats.tableProbes);
+    int tableMove = context.table.probe(key.key, entry) ? moveFromTable(entry.bestMove, key) : NO_MOVE;
+    TTD_STAT(context.stats.tableHits += tableMove != NO_MOVE);
+    MoveList<B> moves;
+    orderMoves<B>(root.legalMoves(), tableMove, moves);
+
+    const int beta = static_cast<int>(State::WIN) + 1;
+    MoveLine reply;
+    ++context.nodes;
+    ++context.ply;
+    Position<B> first = root;
+    first.make(moves[0]);
+    int bestScore = -alphaBeta(first, depth - 1, -beta, -(static_cast<int>(State::LOSS) - 1), context, reply);
+    --context.ply;
+    extendLine(line, moves[0], reply);
+    if (context.aborted)
+    {
+        return 0;
+    } // end if
+
+    int bestIndex = 0;
+    std::mutex bestLock;
+    std::atomic<int> alpha{bestScore};
+    pool.parallelFor(moves.size() - 1, [&](std::size_t task)
+                     {
+        int index = static_cast<int>(task) + 1;
+        SearchContext brother{context.table, context.limits, context.shared};
+        brother.ply = 1;
+        int windowAlpha = alpha.load(std::memory_order_relaxed);
+        MoveLine brotherReply;
+        Position<B> position = root;
+        position.make(moves[index]);
+        int score = -alphaBeta(position, depth - 1, -beta, -windowAlpha, brother, brotherReply);
+
+        std::lock_guard<std::mutex> guard(bestLock);
+        context.nodes += brother.nodes;
+        context.aborted = context.aborted || brother.aborted;
+        TTD_STAT(context.stats.add(brother.stats));
+
+        //
+        // Only a score above the window it was searched with is exact.
+        if (brother.aborted || score <= windowAlpha)
+        {
+            return;
+        } // end if
+
+        if (score > bestScore || (score == bestScore && index < bestIndex))
+        {
+            bestScore = score;
+            extendLine(line, moves[index], brotherReply);
+            bestIndex = index;
+            alpha.store(std::max(alpha.load(std::memory_order_relaxed), score), std::memory_order_relaxed);
+        } // end if
+    });
+
+    if (!context.aborted)
+    {
+        context.table.store(key.key, bestScore, moveToTable(line.moves[0], key), Bound::EXACT, depth);
+    } // end if
+
+    return bestScore;
+} // end of function parallelRoot
+
+//
+// Search one ply deeper at a time until the game is solved or the budget
+// runs out. The answer always comes from the last depth that finished,
+// before the first one finishes it is the first legal move in B::MOVE_ORDER.
+// The root moves are split over the pool when one is given.
+//
+template <typename B>
+static SearchResult deepen(const Position<B> &root, const SearchLimits &limits, TranspositionTable &table, ThreadPool *pool)
+{
+    TTD_STAT(std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now());
+    SharedSearch shared;
+    SearchContext context{table, limits, pool != nullptr ? &shared : nullptr};
+    SearchResult result;
+    Position<B> position = root;
+    typename B::Mask legalMoves = position.legalMoves();
+    for (int cell : B::MOVE_ORDER)
+    {
+        if (legalMoves & B::cellMask(cell))
+        {
+            result.move = cell;
+            break;
+        } // end if
+
+    } // end for
+
+    int lastDepth = std::popcount(legalMoves);
+    if (limits.maxDepth > 0)
+    {
+        lastDepth = std::min(lastDepth, limits.maxDepth);
+    } // end if
+
+    if (position.state() != static_cast<int>(State::DRAW))
+    {
+        result.move = NO_MOVE;
+        result.score = position.state();
+        lastDepth = 0;
+    } // end if
+
+    MoveLine line;
+    for (int depth = 1; depth <= lastDepth; ++depth)
+    {
+        int score;
+        if (pool != nullptr)
+        {
+            score = parallelRoot(position, depth, context, *pool, line);
+        } // end if
+        else
+        {
+            score = alphaBeta(position, depth,
+                              static_cast<int>(State::LOSS) - 1,
+                              static_cast<int>(State::WIN) + 1,
+                              context, line);
+        } // end else
+
+        if (context.aborted)
+        {
+            break;
+        } // end if
+
+        result.line = line;
+        result.move = line.moves[0];
+        result.score = score;
+        result.depth = depth;
+
+        //
+        // A proven win or loss will not change with more depth, iterations
+        // before it would have found a quicker one.
+        if (isDecided(score))
+        {
+            break;
+        } // end if
+
+    } // end for
+
+    if (result.depth > 0)
+    {
+        completeLine(root, table, isDecided(result.score) ? B::CELLS : result.depth, result.line);
+    } // end if
+
+    result.nodes = context.nodes;
+    TTD_STAT(finishStats(context, start, result));
+    return result;
+} // end of function deepen
+
+template <typename B>
+SearchResult iterativeDeepeningSearch(const Position<B> &root, const SearchLimits &limits, TranspositionTable &table)
+{
+    return deepen(root, limits, table, nullptr);
+} // end of function iterativeDeepeningSearch
+
+template <typename B>
+SearchResult iterativeDeepeningSearch(B board, const SearchLimits &limits, TranspositionTable &table)
+{
+    return deepen(Position<B>(board), limits, table, nullptr);
+} // end of function iterativeDeepeningSearch
+
+template <typename B>
+SearchResult parallelSearch(const Position<B> &root, const SearchLimits &limits, TranspositionTable &table, ThreadPool &pool)
+{
+    return deepen(root, limits, table, &pool);
+} // end of function parallelSearch
+
+template <typename B>
+SearchResult parallelSearch(B board, const SearchLimits &limits, TranspositionTable &table, ThreadPool &pool)
+{
+    return deepen(Position<B>(board), limits, table, &pool);
+} // end of function parallelSearch
+
+//
+// Best move within a time and node budget, from the opening book when it
+// has the board, otherwise searched using the shared table
+//
+template <typename B>
+SearchResult findBestMove(B board, const SearchLimits &limits)
+{
+    SearchResult result;
+    if (probeBook(openingBook<B>(), board, result) || probeTablebase(endgameTablebase<B>(), board, result))
+    {
+        return result;
+    } // end if
+    sharedSearchTable<B>().newSearch();
+    return iterativeDeepeningSearch(board, limits, sharedSearchTable<B>());
+} // end of function findBestMove
+
+template <typename B>
+SearchResult findBestMove(B board, const SearchLimits &limits, ThreadPool &pool)
+{
+    SearchResult result;
+    if (probeBook(openingBook<B>(), board, result) || probeTablebase(endgameTablebase<B>(), board, result))
+    {
+        return result;
+    } // end if
+    sharedSearchTable<B>().newSearch();
+    return parallelSearch(board, limits, sharedSearchTable<B>(), pool);
+} // end of function findBestMove
+
+//
+// Best moves for a whole batch of boards. Boards are sorted so copies of
+// the same position sit next to each other and are searched once, then
+// the distinct positions are spread over the pool sharing one table.
+// Finished games are answered with NO_MOVE and their final score, boards
+// in the opening book straight from it.
+// Only min(boards, results) boards are looked at.
+//
+template <typename B>
+void findBestMoves(std::span<const B> boards, std::span<SearchResult> results, const SearchLimits &limits, ThreadPool &pool)
+{
+    std::size_t count = std::min(boards.size(), results.size());
+    std::vector<std::uint32_t> order(count);
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        order[index] = static_cast<std::uint32_t>(index);
+    } // end for
+
+    std::sort(order.begin(), order.end(), [&](std::uint32_t left, std::uint32_t right)
+              { return boards[left].x != boards[right].x ? boards[left].x < boards[right].x
+                                                         : boards[left].o < boards[right].o; });
+
+    std::vector<std::size_t> groupStarts;
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        if (index == 0 || boards[order[index]].x != boards[order[index - 1]].x ||
+            boards[order[index]].o != boards[order[index - 1]].o)
+        {
+            groupStarts.push_back(index);
+        } // end if
+
+    } // end for
+    groupStarts.push_back(count);
+
+    //
+    // Boards small enough for the SIMD kernel are classified in one go so
+    // finished games skip the search entirely.
+    std::vector<Outcome> outcomes(groupStarts.size() - 1, Outcome::ONGOING);
+    if constexpr (B::CELLS <= 16)
+    {
+        std::vector<std::uint16_t> xs(outcomes.size());
+        std::vector<std::uint16_t> os(outcomes.size());
+        for (std::size_t group = 0; group < outcomes.size(); ++group)
+        {
+            xs[group] = boards[order[groupStarts[group]]].x;
+            os[group] = boards[order[groupStarts[group]]].o;
+        } // end for
+        classifyBoards<B>(xs, os, outcomes);
+    } // end if
+
+    TranspositionTable &table = sharedSearchTable<B>();
+    table.newSearch();
+    pool.parallelFor(groupStarts.size() - 1, [&](std::size_t group)
+                     {
+        const B &board = boards[order[groupStarts[group]]];
+        SearchResult result;
+        if (outcomes[group] != Outcome::ONGOING)
+        {
+            result.score = boardState(board, xToMove(board));
+        } // end if
+        else if (!probeBook(openingBook<B>(), board, result) && !probeTablebase(endgameTablebase<B>(), board, result))
+        {
+            result = iterativeDeepeningSearch(board, limits, table);
+        } // end else if
+        for (std::size_t index = groupStarts[group]; index < groupStarts[group + 1]; ++index)
+        {
+            results[order[index]] = result;
+        } // end for
+    });
+} // end of function findBestMoves
+
+template SearchResult alphaBetaSearch(Board board, TranspositionTable &table);
+template SearchResult alphaBetaSearch(Board4x4 board, TranspositionTable &table);
+template SearchResult alphaBetaSearch(Board5x5 board, TranspositionTable &table);
+template SearchResult alphaBetaSearch(Board7x7 board, TranspositionTable &table);
+template SearchResult alphaBetaSearch(const Position<Board> &root, TranspositionTable &table);
+template SearchResult alphaBetaSearch(const Position<Board4x4> &root, TranspositionTable &table);
+template SearchResult alphaBetaSearch(const Position<Board5x5> &root, TranspositionTable &table);
+template SearchResult alphaBetaSearch(const Position<Board7x7> &root, TranspositionTable &table);
+
+template SearchResult iterativeDeepeningSearch(Board board, const SearchLimits &limits, TranspositionTable &table);
+template SearchResult iterativeDeepeningSearch(Board4x4 board, const SearchLimits &limits, TranspositionTable &table);
+template SearchResult iterativeDeepeningSearch(Board5x5 board, const SearchLimits &limits, TranspositionTable &table);
+template SearchResult iterativeDeepeningSearch(Board7x7 board, const SearchLimits &limits, TranspositionTable &table);
+template SearchResult iterativeDeepeningSearch(const Position<Board> &root, const SearchLimits &limits, TranspositionTable &table);
+template SearchResult iterativeDeepeningSearch(const Position<Board4x4> &root, const SearchLimits &limits, TranspositionTable &table);
+template SearchResult iterativeDeepeningSearch(const Position<Board5x5> &root, const SearchLimits &limits, TranspositionTable &table);
+template SearchResult iterativeDeepeningSearch(const Position<Board7x7> &root, const SearchLimits &limits, TranspositionTable &table);
+
+template SearchResult findBestMove(Board board, const SearchLimits &limits);
+template SearchResult findBestMove(Board4x4 board, const SearchLimits &limits);
+template SearchResult findBestMove(Board5x5 board, const SearchLimits &limits);
+template SearchResult findBestMove(Board7x7 board, const SearchLimits &limits);
+
+template SearchResult parallelSearch(Board board, const SearchLimits &limits, TranspositionTable &table, ThreadPool &pool);
+template SearchResult parallelSearch(Board4x4 board, const SearchLimits &limits, TranspositionTable &table, ThreadPool &pool);
+template SearchResult parallelSearch(Board5x5 board, const SearchLimits &limits, TranspositionTable &table, ThreadPool &pool);
+template SearchResult parallelSearch(Board7x7 board, const SearchLimits &limits, TranspositionTable &table, ThreadPool &pool);
+template SearchResult parallelSearch(const Position<Board> &root, const SearchLimits &limits, TranspositionTable &table, ThreadPool &pool);
+template SearchResult parallelSearch(const Position<Board4x4> &root, const SearchLimits &limits, TranspositionTable &table, ThreadPool &pool);
+template SearchResult parallelSearch(const Position<Board5x5> &root, const SearchLimits &limits, TranspositionTable &table, ThreadPool &pool);
+template SearchResult parallelSearch(const Position<Board7x7> &root, const SearchLimits &limits, TranspositionTable &table, ThreadPool &pool);
+
+template SearchResult findBestMove(Board board, const SearchLimits &limits, ThreadPool &pool);
+template SearchResult findBestMove(Board4x4 board, const SearchLimits &limits, ThreadPool &pool);
+template SearchResult findBestMove(Board5x5 board, const SearchLimits &limits, ThreadPool &pool);
+template SearchResult findBestMove(Board7x7 board, const SearchLimits &limits, ThreadPool &pool);
+
+template void findBestMoves(std::span<const Board> boards, std::span<SearchResult> results, const SearchLimits &limits, ThreadPool &pool);
+template void findBestMoves(std::span<const Board4x4> boards, std::span<SearchResult> results, const SearchLimits &limits, ThreadPool &pool);
+template void findBestMoves(std::span<const Board5x5> boards, std::span<SearchResult> results, const SearchLimits &limits, ThreadPool &pool);
+template void findBestMoves(std::span<const Board7x7> boards, std::span<SearchResult> results, const SearchLimits &limits, ThreadPool &pool);
+
+template int evaluateBoard(Board board, bool forX);
+template int evaluateBoard(Board4x4 board, bool forX);
+template int evaluateBoard(Board5x5 board, bool forX);
+template int evaluateBoard(Board7x7 board, bool forX);
+
+template TranspositionTable &sharedSearchTable<Board>();
+template TranspositionTable &sharedSearchTable<Board4x4>();
+template TranspositionTable &sharedSearchTable<Board5x5>();
+template TranspositionTable &sharedSearchTable<Board7x7>();
@@ -0,0 +1,110 @@
+//
+// file: search.hpp
+// author: Michael Brockus
+// gmail: <michaelbrockus@gmail.com>
+//
+#ifndef SEARCH_HPP
+#define SEARCH_HPP
+
+#include "board.hpp"
+#include "position.hpp"
+#include "stats.hpp"
+#include "thread_pool.hpp"
+#include "transposition.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <span>
+
+//
+// Longest game on any board the search is built for
+const int MAX_LINE_LENGTH = 64;
+
+//
+// Moves both sides are expected to play from the root, best first
+//
+struct MoveLine
+{
+    std::array<std::int8_t, MAX_LINE_LENGTH> moves{};
+    int length = 0;
+};
+
+//
+// Outcome of a search, the score is from the point of view of the side to
+// move and depth is the last depth searched to completion. The line starts
+// with the move and runs as far as the search looked, to the end of the
+// game once it is decided. The stats stay zero when instrumentation is
+// compiled out.
+//
+struct SearchResult
+{
+    int move = NO_MOVE;
+    int score = 0;
+    int depth = 0;
+    std::uint64_t nodes = 0;
+    MoveLine line;
+    SearchStats stats;
+};
+
+//
+// Budget for one search, the defaults search to the end of the game.
+// The clock and the stop flag are read every DEADLINE_CHECK_NODES nodes,
+// so a search can overrun its deadline or a request to stop by the time
+// those nodes take. Another thread setting the stop flag cancels the
+// search, which answers from the last depth it finished.
+//
+struct SearchLimits
+{
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+    std::uint64_t maxNodes = 0;
+    int maxDepth = 0;
+    const std::atomic<bool> *stop = nullptr;
+};
+
+const std::uint64_t DEADLINE_CHECK_NODES = 1024;
+
+//
+// Table size for boards too big for a perfect base 3 key
+const std::size_t LARGE_TABLE_ENTRIES = 1 << 20;
+
+//
+// The search is defined in search.cpp and instantiated there for Board,
+// Board4x4, Board5x5 and Board7x7.
+//
+// The search runs on a Position, the overloads taking a bare board start
+// from the side to move its mark count implies.
+template <typename B>
+SearchResult alphaBetaSearch(const Position<B> &root, TranspositionTable &table);
+
+template <typename B>
+SearchResult alphaBetaSearch(B board, TranspositionTable &table);
+
+template <typename B>
+SearchResult iterativeDeepeningSearch(const Position<B> &root, const SearchLimits &limits, TranspositionTable &table);
+
+template <typename B>
+SearchResult iterativeDeepeningSearch(B board, const SearchLimits &limits, TranspositionTable &table);
+
+template <typename B>
+SearchResult parallelSearch(const Position<B> &root, const SearchLimits &limits, TranspositionTable &table, ThreadPool &pool);
+
+template <typename B>
+SearchResult parallelSearch(B board, const SearchLimits &limits, TranspositionTable &table, ThreadPool &pool);
+
+template <typename B>
+SearchResult findBestMove(B board, const SearchLimits &limits);
+
+template <typename B>
+SearchResult findBestMove(B board, const SearchLimits &limits, ThreadPool &pool);
+
+template <typename B>
+void findBestMoves(std::span<const B> boards, std::span<SearchResult> results, const SearchLimits &limits, ThreadPool &pool);
+
+template <typename B>
+int evaluateBoard(B board, bool forX);
+
+template <typename B = Board>
+TranspositionTable &sharedSearchTable();
+
+#endif // end of SEARCH_HPP
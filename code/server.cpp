@@ -0,0 +1,278 @@
+//
+// file: server.cpp
+// author: Michael Brockus
+// gmail: <michaelbrockus@gmail.com>
+//
+#include "server.hpp"
+#include "game.hpp"
+#include "solved.hpp"
+#include "stats.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <cstring>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+//
+// Answer one request line, see server.hpp for the protocol
+//
+std::string GameServer::handleLine(std::string_view line)
+{
+    if (line == "stats")
+    {
+        return "stats " + formatStats(searchTotals()) + "\n";
+    } // end if
+
+    std::istringstream request{std::string(line)};
+    std::uint64_t gameId = 0;
+    std::string first;
+    if (!(request >> gameId >> first))
+    {
+        return "0 error malformed request\n";
+    } // end if
+
+    std::ostringstream reply;
+    reply << gameId << ' ';
+    if (first == "end")
+    {
+        games.erase(gameId);
+        reply << "-1 -1 ended\n";
+        return reply.str();
+    } // end if
+
+    int row = -1;
+    int col = -1;
+    std::istringstream rowText(first);
+    if (!(rowText >> row) || !(request >> col) || row < 0 || row >= Board::ROWS || col < 0 || col >= Board::COLS)
+    {
+        reply << "error bad position\n";
+        return reply.str();
+    } // end if
+
+    Board &board = games[gameId];
+    int cell = cellIndex(row, col);
+    if ((occupiedCells(board) & cellMask(cell)) != 0)
+    {
+        reply << "error position occupied\n";
+        return reply.str();
+    } // end if
+
+    board = playMove(board, cell, true);
+    int engineMove = NO_MOVE;
+    if (boardState(board, false) == static_cast<int>(State::DRAW) && !boardFull(board))
+    {
+        TTD_STAT(std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now());
+        engineMove = lookupSolved(board).move;
+        board = playMove(board, engineMove, false);
+        TTD_STAT(recordLookups(1, nanosSince(start)));
+    } // end if
+
+    const char *state = gameStateName(board);
+    if (engineMove == NO_MOVE)
+    {
+        reply << "-1 -1 " << state << '\n';
+    } // end if
+    else
+    {
+        reply << engineMove / Board::COLS << ' ' << engineMove % Board::COLS << ' ' << state << '\n';
+    } // end else
+
+    if (std::string_view(state) != "playing")
+    {
+        games.erase(gameId);
+    } // end if
+    return reply.str();
+} // end of function handleLine
+
+void GameServer::stop()
+{
+    stopping.store(true, std::memory_order_relaxed);
+} // end of function stop
+
+std::size_t GameServer::gameCount() const
+{
+    return games.size();
+} // end of function gameCount
+
+#if defined(__linux__)
+
+const int EVENT_BATCH = 64;
+const int STOP_POLL_MS = 100;
+
+//
+// One connected client, bytes read but not yet a full line and replies
+// not yet written
+//
+struct Connection
+{
+    std::string input;
+    std::string output;
+    bool writing = false;
+};
+
+//
+// Write as much pending output as the socket takes, false on a dead client
+//
+static bool flushOutput(int fd, Connection &connection)
+{
+    while (!connection.output.empty())
+    {
+        ssize_t written = send(fd, connection.output.data(), connection.output.size(), MSG_NOSIGNAL);
+        if (written < 0)
+        {
+            return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+        } // end if
+        connection.output.erase(0, static_cast<std::size_t>(written));
+    } // end while
+
+    return true;
+} // end of function flushOutput
+
+//
+// Serve clients on a Unix domain socket until stop() is called. Every
+// socket is non-blocking, reads are drained until they would block and
+// unsent replies wait for the socket to become writable again.
+//
+int GameServer::run(const std::string &socketPath)
+{
+    sockaddr_un address{};
+    if (socketPath.size() >= sizeof(address.sun_path))
+    {
+        std::cerr << "socket path too long: " << socketPath << std::endl;
+        return EXIT_FAILURE;
+    } // end if
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+    int listener = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    unlink(socketPath.c_str());
+    if (listener < 0 || bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0 ||
+        listen(listener, SOMAXCONN) < 0)
+    {
+        std::cerr << "cannot listen on " << socketPath << ": " << std::strerror(errno) << std::endl;
+        if (listener >= 0)
+        {
+            close(listener);
+        } // end if
+        return EXIT_FAILURE;
+    } // end if
+
+    int poller = epoll_create1(EPOLL_CLOEXEC);
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = listener;
+    epoll_ctl(poller, EPOLL_CTL_ADD, listener, &event);
+
+    std::unordered_map<int, Connection> connections;
+    epoll_event ready[EVENT_BATCH];
+    while (!stopping.load(std::memory_order_relaxed))
+    {
+        int readyCount = epoll_wait(poller, ready, EVENT_BATCH, STOP_POLL_MS);
+        if (readyCount < 0 && errno == EINTR)
+        {
+            continue; // a signal may have asked to stop
+        } // end if
+        for (int index = 0; index < readyCount; ++index)
+        {
+            int fd = ready[index].data.fd;
+            if (fd == listener)
+            {
+                int client;
+                while ((client = accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0)
+                {
+                    event.events = EPOLLIN | EPOLLRDHUP;
+                    event.data.fd = client;
+                    epoll_ctl(poller, EPOLL_CTL_ADD, client, &event);
+                    connections[client];
+                } // end while
+                continue;
+            } // end if
+
+            Connection &connection = connections[fd];
+            bool alive = (ready[index].events & (EPOLLERR | EPOLLHUP)) == 0;
+            if (alive && (ready[index].events & (EPOLLIN | EPOLLRDHUP)) != 0)
+            {
+                char buffer[4096];
+                while (true)
+                {
+                    ssize_t received = recv(fd, buffer, sizeof(buffer), 0);
+                    if (received > 0)
+                    {
+                        connection.input.append(buffer, static_cast<std::size_t>(received));
+                        continue;
+                    } // end if
+                    alive = received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR);
+                    break;
+                } // end while
+
+                std::size_t start = 0;
+                std::size_t end;
+                while ((end = connection.input.find('\n', start)) != std::string::npos)
+                {
+                    connection.output += handleLine(std::string_view(connection.input).substr(start, end - start));
+                    start = end + 1;
+                } // end while
+                connection.input.erase(0, start);
+
+                //
+                // A client that never sends a newline is cut off
+                if (connection.input.size() > MAX_REQUEST_LINE)
+                {
+                    alive = false;
+                } // end if
+            } // end if
+
+            //
+            // Replies to a client that hung up after sending are still sent
+            if (!connection.output.empty() && !flushOutput(fd, connection))
+            {
+                alive = false;
+            } // end if
+
+            if (!alive)
+            {
+                epoll_ctl(poller, EPOLL_CTL_DEL, fd, nullptr);
+                close(fd);
+                connections.erase(fd);
+                continue;
+            } // end if
+
+            bool wantWrite = !connection.output.empty();
+            if (wantWrite != connection.writing)
+            {
+                event.events = EPOLLIN | EPOLLRDHUP | (wantWrite ? EPOLLOUT : 0u);
+                event.data.fd = fd;
+                epoll_ctl(poller, EPOLL_CTL_MOD, fd, &event);
+                connection.writing = wantWrite;
+            } // end if
+
+        } // end for
+    } // end while
+
+    for (const auto &[fd, connection] : connections)
+    {
+        close(fd);
+    } // end for
+    close(poller);
+    close(listener);
+    unlink(socketPath.c_str());
+    return EXIT_SUCCESS;
+} // end of function run
+
+#else
+
+int GameServer::run(const std::string &socketPath)
+{
+    std::cerr << "server mode needs epoll, it is only available on Linux: " << socketPath << std::endl;
+    return EXIT_FAILURE;
+} // end of function run
+
+#endif // end of __linux__
@@ -0,0 +1,51 @@
+//
+// file: server.hpp
+// author: Michael Brockus
+// gmail: <michaelbrockus@gmail.com>
+//
+#ifndef SERVER_HPP
+#define SERVER_HPP
+
+#include "board.hpp"
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+const char DEFAULT_SOCKET_PATH[] = "/tmp/tic-tac-dodo.sock";
+const std::size_t MAX_REQUEST_LINE = 256;
+
+//
+// Headless server hosting any number of games in one process. Clients
+// talk to it over a Unix domain socket with one request per line:
+//
+//     <game> <row> <col>    player X moves, the game starts on first use
+//     <game> end            forget the game
+//     stats                 search statistics of the whole process
+//
+// and get one reply line per request:
+//
+//     <game> <row> <col> <state>    the engine's move, -1 -1 when it has
+//                                   none, state is one of playing, x-wins,
+//                                   o-wins or draw
+//     <game> error <reason>
+//     stats <key>=<value> ...
+//
+// Finished games are forgotten once their final reply is sent. The event
+// loop is a single thread on epoll and never blocks on a client.
+//
+class GameServer
+{
+public:
+    std::string handleLine(std::string_view line);
+    int run(const std::string &socketPath);
+    void stop();
+    std::size_t gameCount() const;
+
+private:
+    std::unordered_map<std::uint64_t, Board> games;
+    std::atomic<bool> stopping{false};
+};
+
+#endif // end of SERVER_HPP
@@ -0,0 +1,191 @@
+//
+// file: simd_kernel.cpp
+// author: Michael Brockus
+// gmail: <michaelbrockus@gmail.com>
+//
+#include "simd_kernel.hpp"
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define TTD_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+//
+// One board at a time, also finishes whatever the vector loops leave over
+//
+static void classifyScalar(const std::uint16_t *x, const std::uint16_t *o, Outcome *outcomes,
+                           std::size_t count, std::span<const std::uint16_t> lines, std::uint16_t fullMask)
+{
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        bool xWins = false;
+        bool oWins = false;
+        for (std::uint16_t line : lines)
+        {
+            xWins = xWins || ((x[index] & line) == line);
+            oWins = oWins || ((o[index] & line) == line);
+        } // end for
+
+        if (xWins)
+        {
+            outcomes[index] = Outcome::X_WINS;
+        } // end if
+        else if (oWins)
+        {
+            outcomes[index] = Outcome::O_WINS;
+        } // end else if
+        else if ((x[index] | o[index]) == fullMask)
+        {
+            outcomes[index] = Outcome::DRAW;
+        } // end else if
+        else
+        {
+            outcomes[index] = Outcome::ONGOING;
+        } // end else
+
+    } // end for
+} // end of function classifyScalar
+
+#if defined(TTD_X86_KERNELS)
+
+//
+// Turn the per lane all-ones flags into Outcome values, X winning first
+//
+__attribute__((target("sse2"))) static inline __m128i outcomeLanes(__m128i xWins, __m128i oWins, __m128i full)
+{
+    __m128i result = _mm_and_si128(xWins, _mm_set1_epi16(static_cast<short>(Outcome::X_WINS)));
+    result = _mm_or_si128(result, _mm_and_si128(_mm_andnot_si128(xWins, oWins),
+                                                 _mm_set1_epi16(static_cast<short>(Outcome::O_WINS))));
+    result = _mm_or_si128(result, _mm_and_si128(_mm_andnot_si128(_mm_or_si128(xWins, oWins), full),
+                                                _mm_set1_epi16(static_cast<short>(Outcome::DRAW))));
+    return result;
+} // end of function outcomeLanes
+
+__attribute__((target("sse2"))) static std::size_t classifySse2(const std::uint16_t *x, const std::uint16_t *o, Outcome *outcomes,
+                                                                std::size_t count, std::span<const std::uint16_t> lines, std::uint16_t fullMask)
+{
+    const __m128i full = _mm_set1_epi16(static_cast<short>(fullMask));
+    std::size_t index = 0;
+    for (; index + 8 <= count; index += 8)
+    {
+        __m128i xs = _mm_loadu_si128(reinterpret_cast<const __m128i *>(x + index));
+        __m128i os = _mm_loadu_si128(reinterpret_cast<const __m128i *>(o + index));
+        __m128i xWins = _mm_setzero_si128();
+        __m128i oWins = _mm_setzero_si128();
+        for (std::uint16_t line : lines)
+        {
+            __m128i mask = _mm_set1_epi16(static_cast<short>(line));
+            xWins = _mm_or_si128(xWins, _mm_cmpeq_epi16(_mm_and_si128(xs, mask), mask));
+            oWins = _mm_or_si128(oWins, _mm_cmpeq_epi16(_mm_and_si128(os, mask), mask));
+        } // end for
+
+        __m128i isFull = _mm_cmpeq_epi16(_mm_or_si128(xs, os), full);
+        __m128i packed = _mm_packus_epi16(outcomeLanes(xWins, oWins, isFull), _mm_setzero_si128());
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(outcomes + index), packed);
+    } // end for
+
+    return index;
+} // end of function classifySse2
+
+__attribute__((target("avx2"))) static std::size_t classifyAvx2(const std::uint16_t *x, const std::uint16_t *o, Outcome *outcomes,
+                                                                std::size_t count, std::span<const std::uint16_t> lines, std::uint16_t fullMask)
+{
+    const __m256i full = _mm256_set1_epi16(static_cast<short>(fullMask));
+    std::size_t index = 0;
+    for (; index + 16 <= count; index += 16)
+    {
+        __m256i xs = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(x + index));
+        __m256i os = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(o + index));
+        __m256i xWins = _mm256_setzero_si256();
+        __m256i oWins = _mm256_setzero_si256();
+        for (std::uint16_t line : lines)
+        {
+            __m256i mask = _mm256_set1_epi16(static_cast<short>(line));
+            xWins = _mm256_or_si256(xWins, _mm256_cmpeq_epi16(_mm256_and_si256(xs, mask), mask));
+            oWins = _mm256_or_si256(oWins, _mm256_cmpeq_epi16(_mm256_and_si256(os, mask), mask));
+        } // end for
+
+        __m256i isFull = _mm256_cmpeq_epi16(_mm256_or_si256(xs, os), full);
+
+        //
+        // Finish in two 128 bit halves so the 16 results pack in order
+        __m128i low = outcomeLanes(_mm256_castsi256_si128(xWins), _mm256_castsi256_si128(oWins),
+                                   _mm256_castsi256_si128(isFull));
+        __m128i high = outcomeLanes(_mm256_extracti128_si256(xWins, 1), _mm256_extracti128_si256(oWins, 1),
+                                    _mm256_extracti128_si256(isFull, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(outcomes + index), _mm_packus_epi16(low, high));
+    } // end for
+
+    return index;
+} // end of function classifyAvx2
+
+#endif // end of TTD_X86_KERNELS
+
+//
+// Best instruction set this CPU supports, checked once
+//
+SimdLevel detectSimdLevel()
+{
+#if defined(TTD_X86_KERNELS)
+    static const SimdLevel level = []
+    {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+        {
+            return SimdLevel::AVX2;
+        } // end if
+        else if (__builtin_cpu_supports("sse2"))
+        {
+            return SimdLevel::SSE2;
+        } // end else if
+
+        return SimdLevel::SCALAR;
+    }();
+    return level;
+#else
+    return SimdLevel::SCALAR;
+#endif
+} // end of function detectSimdLevel
+
+const char *simdLevelName(SimdLevel level)
+{
+    switch (level)
+    {
+    case SimdLevel::AVX2:
+        return "avx2";
+    case SimdLevel::SSE2:
+        return "sse2";
+    default:
+        return "scalar";
+    } // end switch
+} // end of function simdLevelName
+
+//
+// Run the widest kernel asked for that this CPU has, the scalar loop
+// picks up the boards left over at the end
+//
+void classifyBoards(std::span<const std::uint16_t> x,
+                    std::span<const std::uint16_t> o,
+                    std::span<Outcome> outcomes,
+                    std::span<const std::uint16_t> lines,
+                    std::uint16_t fullMask,
+                    SimdLevel level)
+{
+    std::size_t count = std::min({x.size(), o.size(), outcomes.size()});
+    std::size_t done = 0;
+#if defined(TTD_X86_KERNELS)
+    level = std::min(level, detectSimdLevel());
+    if (level == SimdLevel::AVX2)
+    {
+        done = classifyAvx2(x.data(), o.data(), outcomes.data(), count, lines, fullMask);
+    } // end if
+    else if (level == SimdLevel::SSE2)
+    {
+        done = classifySse2(x.data(), o.data(), outcomes.data(), count, lines, fullMask);
+    } // end else if
+#else
+    (void)level;
+#endif
+    classifyScalar(x.data() + done, o.data() + done, outcomes.data() + done, count - done, lines, fullMask);
+} // end of function classifyBoards
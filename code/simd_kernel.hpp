@@ -0,0 +1,56 @@
+//
+// file: simd_kernel.hpp
+// author: Michael Brockus
+// gmail: <michaelbrockus@gmail.com>
+//
+#ifndef SIMD_KERNEL_HPP
+#define SIMD_KERNEL_HPP
+
+#include "board.hpp"
+#include <cstdint>
+#include <span>
+
+//
+// Terminal state of a board, a board where both sides have a line counts
+// as won by X
+enum class Outcome : std::uint8_t
+{
+    ONGOING = 0,
+    X_WINS = 1,
+    O_WINS = 2,
+    DRAW = 3
+};
+
+//
+// Instruction sets the kernel can run on, picked once at runtime
+enum class SimdLevel
+{
+    SCALAR,
+    SSE2,
+    AVX2
+};
+
+SimdLevel detectSimdLevel();
+const char *simdLevelName(SimdLevel level);
+
+//
+// Classify boards stored as separate X and O mask arrays. SSE2 checks 8
+// boards per instruction and AVX2 16, against every win line mask at
+// once. Only boards of up to 16 cells fit the 16 bit lanes, which covers
+// Board and Board4x4. Only the shortest of the three spans is processed.
+//
+void classifyBoards(std::span<const std::uint16_t> x,
+                    std::span<const std::uint16_t> o,
+                    std::span<Outcome> outcomes,
+                    std::span<const std::uint16_t> lines,
+                    std::uint16_t fullMask,
+                    SimdLevel level = detectSimdLevel());
+
+template <typename B>
+void classifyBoards(std::span<const std::uint16_t> x, std::span<const std::uint16_t> o, std::span<Outcome> outcomes)
+{
+    static_assert(B::CELLS <= 16, "the kernel works on 16 bit boards");
+    classifyBoards(x, o, outcomes, B::LINES, B::FULL);
+} // end of function classifyBoards
+
+#endif // end of SIMD_KERNEL_HPP
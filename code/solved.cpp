@@ -0,0 +1,185 @@
+//
+// file: solved.cpp
+// author: Michael Brockus
+// gmail: <michaelbrockus@gmail.com>
+//
+// USE CASE:
+//
+// The whole 3x3 game is solved by the compiler. Every one of the 3^9
+// boards, reachable or not, gets its value and best move with the same
+// rules the search uses, so a lookup here is interchangeable with
+// alphaBetaSearch, down to the plies left in a won or lost game, and
+// costs nothing at startup.
+//
+#include "solved.hpp"
+#include <array>
+
+//
+// Packed entry layout: bits 0-3 best move (15 for none), bits 4-5 score
+// (0 loss, 1 draw, 2 win), bit 6 set when the position can come up in a
+// game starting from the empty board and bits 8-11 the plies left to the
+// end of a won or lost game.
+const std::uint16_t MOVE_BITS = 0x0F;
+const std::uint16_t NO_MOVE_BITS = 0x0F;
+const int SCORE_SHIFT = 4;
+const std::uint16_t REACHABLE_BIT = 0x40;
+const int PLIES_SHIFT = 8;
+
+constexpr std::array<std::uint32_t, BOARD_CELLS> CELL_WEIGHTS{1, 3, 9, 27, 81, 243, 729, 2187, 6561};
+
+//
+// Rebuild the board behind a base 3 position key
+//
+consteval Board boardFromKey(std::uint32_t key)
+{
+    Board board;
+    for (int cell = 0; cell < BOARD_CELLS; ++cell)
+    {
+        std::uint32_t digit = key % 3;
+        key /= 3;
+        if (digit == 1)
+        {
+            board.x |= cellMask(cell);
+        } // end if
+        else if (digit == 2)
+        {
+            board.o |= cellMask(cell);
+        } // end else if
+
+    } // end for
+
+    return board;
+} // end of function boardFromKey
+
+consteval std::uint16_t packScore(int score)
+{
+    if (score >= HEURISTIC_LIMIT)
+    {
+        return static_cast<std::uint16_t>(2 << SCORE_SHIFT | (static_cast<int>(State::WIN) - score) << PLIES_SHIFT);
+    } // end if
+    else if (score <= -HEURISTIC_LIMIT)
+    {
+        return static_cast<std::uint16_t>((score - static_cast<int>(State::LOSS)) << PLIES_SHIFT);
+    } // end else if
+
+    return 1 << SCORE_SHIFT;
+} // end of function packScore
+
+constexpr int unpackScore(std::uint16_t packed)
+{
+    int plies = packed >> PLIES_SHIFT;
+    switch ((packed >> SCORE_SHIFT) & 3)
+    {
+    case 2:
+        return static_cast<int>(State::WIN) - plies;
+    case 0:
+        return static_cast<int>(State::LOSS) + plies;
+    default:
+        return static_cast<int>(State::DRAW);
+    } // end switch
+} // end of function unpackScore
+
+//
+// Solve every board. Playing a move only ever adds to the key, so walking
+// the keys from the top down means every child is solved before its parent.
+// Walking them back up from the empty board then marks what is reachable.
+//
+consteval std::array<std::uint16_t, POSITION_COUNT> solveGame()
+{
+    std::array<std::uint16_t, POSITION_COUNT> table{};
+    for (std::uint32_t key = POSITION_COUNT; key-- > 0;)
+    {
+        Board board = boardFromKey(key);
+        bool forX = xToMove(board);
+        Mask legalMoves = legalMoveMask(board);
+        int boardScore = boardState(board, forX);
+        if ((legalMoves == 0) || (boardScore != static_cast<int>(State::DRAW)))
+        {
+            table[key] = packScore(boardScore) | NO_MOVE_BITS;
+            continue;
+        } // end if
+
+        //
+        // The first move in Board::MOVE_ORDER with the best value wins ties.
+        int bestScore = static_cast<int>(State::LOSS) - 1;
+        int bestMove = NO_MOVE;
+        for (int cell : Board::MOVE_ORDER)
+        {
+            if ((legalMoves & cellMask(cell)) == 0)
+            {
+                continue;
+            } // end if
+
+            std::uint32_t childKey = key + CELL_WEIGHTS[cell] * (forX ? 1 : 2);
+            int score = scoreBeforeMove(unpackScore(table[childKey]));
+            if (score > bestScore)
+            {
+                bestScore = score;
+                bestMove = cell;
+            } // end if
+
+        } // end for
+        table[key] = packScore(bestScore) | static_cast<std::uint16_t>(bestMove);
+    } // end for
+
+    table[0] |= REACHABLE_BIT;
+    for (std::uint32_t key = 0; key < POSITION_COUNT; ++key)
+    {
+        if ((table[key] & REACHABLE_BIT) == 0 || (table[key] & MOVE_BITS) == NO_MOVE_BITS)
+        {
+            continue;
+        } // end if
+
+        Board board = boardFromKey(key);
+        bool forX = xToMove(board);
+        for (Mask moves = legalMoveMask(board); moves != 0; moves &= moves - 1)
+        {
+            table[key + CELL_WEIGHTS[std::countr_zero(moves)] * (forX ? 1 : 2)] |= REACHABLE_BIT;
+        } // end for
+
+    } // end for
+
+    return table;
+} // end of function solveGame
+
+constexpr std::array<std::uint16_t, POSITION_COUNT> SOLVED_TABLE = solveGame();
+
+consteval std::uint32_t countReachable()
+{
+    std::uint32_t count = 0;
+    for (std::uint16_t entry : SOLVED_TABLE)
+    {
+        count += (entry & REACHABLE_BIT) ? 1 : 0;
+    } // end for
+
+    return count;
+} // end of function countReachable
+
+static_assert(countReachable() == 5478, "tic-tac-toe has 5478 reachable positions");
+static_assert((SOLVED_TABLE[0] >> SCORE_SHIFT & 3) == 1, "perfect play from the empty board is a draw");
+
+//
+// Look up perfect play for any board
+//
+SolvedEntry lookupSolved(Board board)
+{
+    return lookupSolved(positionKey(board));
+} // end of function lookupSolved
+
+//
+// Look up perfect play by base 3 position key
+//
+SolvedEntry lookupSolved(std::uint32_t key)
+{
+    std::uint16_t packed = SOLVED_TABLE[key];
+    SolvedEntry entry;
+    entry.score = unpackScore(packed);
+    entry.move = (packed & MOVE_BITS) == NO_MOVE_BITS ? NO_MOVE : (packed & MOVE_BITS);
+    entry.reachable = (packed & REACHABLE_BIT) != 0;
+    return entry;
+} // end of function lookupSolved
+
+std::uint32_t solvedReachableCount()
+{
+    return countReachable();
+} // end of function solvedReachableCount
@@ -0,0 +1,27 @@
+//
+// file: solved.hpp
+// author: Michael Brockus
+// gmail: <michaelbrockus@gmail.com>
+//
+#ifndef SOLVED_HPP
+#define SOLVED_HPP
+
+#include "board.hpp"
+#include <cstdint>
+
+//
+// Perfect play result for one position, the score is from the point of
+// view of the side to move and the move is NO_MOVE once the game is over.
+//
+struct SolvedEntry
+{
+    int score = 0;
+    int move = NO_MOVE;
+    bool reachable = false;
+};
+
+SolvedEntry lookupSolved(Board board);
+SolvedEntry lookupSolved(std::uint32_t key);
+std::uint32_t solvedReachableCount();
+
+#endif // end of SOLVED_HPP
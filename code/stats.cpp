@@ -0,0 +1,74 @@
+//
+// file: stats.cpp
+// author: Michael Brockus
+// gmail: <michaelbrockus@gmail.com>
+//
+#include "stats.hpp"
+#include <algorithm>
+#include <mutex>
+
+//
+// Searches report once when they finish, not per node, so a lock is cheap
+// enough here
+static std::mutex totalsLock;
+static SearchStats totals;
+
+void SearchStats::add(const SearchStats &other)
+{
+    calls += other.calls;
+    nodes += other.nodes;
+    leaves += other.leaves;
+    cutoffs += other.cutoffs;
+    tableProbes += other.tableProbes;
+    tableHits += other.tableHits;
+    wallNanos += other.wallNanos;
+    maxDepth = std::max(maxDepth, other.maxDepth);
+} // end of function add
+
+void recordSearch(const SearchStats &stats)
+{
+    std::lock_guard<std::mutex> guard(totalsLock);
+    totals.add(stats);
+} // end of function recordSearch
+
+//
+// Moves read straight from the solved table count as one call with one
+// table probe and hit each, and no search nodes
+//
+void recordLookups(std::uint64_t count, std::uint64_t wallNanos)
+{
+    SearchStats stats;
+    stats.calls = count;
+    stats.tableProbes = count;
+    stats.tableHits = count;
+    stats.wallNanos = wallNanos;
+    recordSearch(stats);
+} // end of function recordLookups
+
+SearchStats searchTotals()
+{
+    std::lock_guard<std::mutex> guard(totalsLock);
+    return totals;
+} // end of function searchTotals
+
+void resetSearchTotals()
+{
+    std::lock_guard<std::mutex> guard(totalsLock);
+    totals = SearchStats{};
+} // end of function resetSearchTotals
+
+//
+// One line of key=value pairs, the same in logs, on the server and in
+// the batch summary
+//
+std::string formatStats(const SearchStats &stats)
+{
+    return "calls=" + std::to_string(stats.calls) +
+           " nodes=" + std::to_string(stats.nodes) +
+           " leaves=" + std::to_string(stats.leaves) +
+           " cutoffs=" + std::to_string(stats.cutoffs) +
+           " probes=" + std::to_string(stats.tableProbes) +
+           " hits=" + std::to_string(stats.tableHits) +
+           " max_depth=" + std::to_string(stats.maxDepth) +
+           " wall_us=" + std::to_string(stats.wallNanos / 1000);
+} // end of function formatStats
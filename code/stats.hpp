@@ -0,0 +1,59 @@
+//
+// file: stats.hpp
+// author: Michael Brockus
+// gmail: <michaelbrockus@gmail.com>
+//
+#ifndef STATS_HPP
+#define STATS_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+//
+// Instrumentation is on unless the build turns it off with
+// -DTTD_WITH_STATS=0, then every TTD_STAT statement compiles to nothing
+// and the counters stay zero.
+#ifndef TTD_WITH_STATS
+#define TTD_WITH_STATS 1
+#endif
+
+#if TTD_WITH_STATS
+#define TTD_STAT(statement) statement
+#else
+#define TTD_STAT(statement)
+#endif
+
+//
+// What one or more searches did. maxDepth is the deepest ply any of them
+// reached and wallNanos their summed wall time.
+//
+struct SearchStats
+{
+    std::uint64_t calls = 0;
+    std::uint64_t nodes = 0;
+    std::uint64_t leaves = 0;
+    std::uint64_t cutoffs = 0;
+    std::uint64_t tableProbes = 0;
+    std::uint64_t tableHits = 0;
+    std::uint64_t wallNanos = 0;
+    int maxDepth = 0;
+
+    void add(const SearchStats &other);
+};
+
+inline std::uint64_t nanosSince(std::chrono::steady_clock::time_point start)
+{
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+} // end of function nanosSince
+
+//
+// Process wide totals, every top level search adds its own stats here
+void recordSearch(const SearchStats &stats);
+void recordLookups(std::uint64_t count, std::uint64_t wallNanos);
+SearchStats searchTotals();
+void resetSearchTotals();
+std::string formatStats(const SearchStats &stats);
+
+#endif // end of STATS_HPP
@@ -0,0 +1,168 @@
+//
+// file: symmetry.hpp
+// author: Michael Brockus
+// gmail: <michaelbrockus@gmail.com>
+//
+#ifndef SYMMETRY_HPP
+#define SYMMETRY_HPP
+
+#include "board.hpp"
+#include <array>
+#include <cstdint>
+
+//
+// The 8 symmetries of the square: identity, three rotations and four
+// reflections. The winning lines map onto each other under every one of
+// them, so symmetric boards always have the same value.
+const int SYMMETRY_COUNT = 8;
+
+//
+// Where a (row, col) cell ends up under a given symmetry
+//
+constexpr int transformCell(int cell, int symmetry)
+{
+    int row = cell / 3;
+    int col = cell % 3;
+    int newRow = row;
+    int newCol = col;
+    switch (symmetry)
+    {
+    case 1: // rotate 90
+        newRow = col;
+        newCol = 2 - row;
+        break;
+    case 2: // rotate 180
+        newRow = 2 - row;
+        newCol = 2 - col;
+        break;
+    case 3: // rotate 270
+        newRow = 2 - col;
+        newCol = row;
+        break;
+    case 4: // mirror left to right
+        newCol = 2 - col;
+        break;
+    case 5: // mirror top to bottom
+        newRow = 2 - row;
+        break;
+    case 6: // main diagonal
+        newRow = col;
+        newCol = row;
+        break;
+    case 7: // anti diagonal
+        newRow = 2 - col;
+        newCol = 2 - row;
+        break;
+    default: // identity
+        break;
+    } // end switch
+
+    return cellIndex(newRow, newCol);
+} // end of function transformCell
+
+//
+// Symmetry that undoes the given one, only the quarter turns are not their own inverse
+//
+constexpr int inverseSymmetry(int symmetry)
+{
+    if (symmetry == 1)
+    {
+        return 3;
+    } // end if
+    else if (symmetry == 3)
+    {
+        return 1;
+    } // end else if
+
+    return symmetry;
+} // end of function inverseSymmetry
+
+//
+// Every cell mask under every symmetry, so transforming a side is one load
+constexpr std::array<std::array<Mask, FULL_BOARD + 1>, SYMMETRY_COUNT> SYMMETRY_MASKS = []
+{
+    std::array<std::array<Mask, FULL_BOARD + 1>, SYMMETRY_COUNT> masks{};
+    for (int symmetry = 0; symmetry < SYMMETRY_COUNT; ++symmetry)
+    {
+        for (int cells = 0; cells <= FULL_BOARD; ++cells)
+        {
+            Mask image = 0;
+            for (int cell = 0; cell < BOARD_CELLS; ++cell)
+            {
+                if ((cells >> cell) & 1)
+                {
+                    image |= cellMask(transformCell(cell, symmetry));
+                } // end if
+
+            } // end for
+            masks[symmetry][cells] = image;
+        } // end for
+
+    } // end for
+
+    return masks;
+}();
+
+constexpr Board transformBoard(Board board, int symmetry)
+{
+    return Board{SYMMETRY_MASKS[symmetry][board.x], SYMMETRY_MASKS[symmetry][board.o]};
+} // end of function transformBoard
+
+//
+// A board in canonical form together with the symmetry that produced it
+//
+struct CanonicalBoard
+{
+    Board board;
+    int symmetry = 0;
+};
+
+//
+// Map a board to the orientation with the smallest position key
+//
+constexpr CanonicalBoard canonicalize(Board board)
+{
+    CanonicalBoard best{board, 0};
+    std::uint32_t bestKey = positionKey(board);
+    for (int symmetry = 1; symmetry < SYMMETRY_COUNT; ++symmetry)
+    {
+        Board image = transformBoard(board, symmetry);
+        std::uint32_t key = positionKey(image);
+        if (key < bestKey)
+        {
+            best = CanonicalBoard{image, symmetry};
+            bestKey = key;
+        } // end if
+
+    } // end for
+
+    return best;
+} // end of function canonicalize
+
+//
+// Take a move chosen on the canonical board back to the original orientation
+//
+constexpr int moveFromCanonical(int move, int symmetry)
+{
+    if (move == NO_MOVE)
+    {
+        return NO_MOVE;
+    } // end if
+
+    return transformCell(move, inverseSymmetry(symmetry));
+} // end of function moveFromCanonical
+
+//
+// Take a move on the original board over to the canonical orientation
+//
+constexpr int moveToCanonical(int move, int symmetry)
+{
+    if (move == NO_MOVE)
+    {
+        return NO_MOVE;
+    } // end if
+
+    return transformCell(move, symmetry);
+} // end of function moveToCanonical
+
+#endif // end of SYMMETRY_HPP
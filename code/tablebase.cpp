@@ -0,0 +1,319 @@
+//
+// file: tablebase.cpp
+// author: Michael Brockus
+// gmail: <michaelbrockus@gmail.com>
+//
+// USE CASE:
+//
+// Endgame tablebases for boards too big to search to the end in time.
+// Every move adds a mark, so the positions with n marks only lead to
+// positions with n + 1, and solving the board is working back one mark
+// count at a time from the full board: a finished game takes its value
+// from the board, any other position the best of its children. Within
+// one mark count the positions do not depend on each other and are
+// shared out over the pool.
+//
+#include "tablebase.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define TTD_HAVE_MMAP 1
+#endif
+
+//
+// Slices of a mark count handed out per pool thread
+const std::uint64_t SLICES_PER_THREAD = 16;
+
+Tablebase::~Tablebase()
+{
+    close();
+} // end of destructor
+
+//
+// Map a tablebase made for the given board size, false if the file is
+// missing, from another version or for another board
+//
+bool Tablebase::open(const std::string &path, int rows, int cols, int inARow)
+{
+    close();
+#if defined(TTD_HAVE_MMAP)
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return false;
+    } // end if
+
+    struct stat info;
+    void *mapped = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && static_cast<std::size_t>(info.st_size) >= sizeof(TablebaseHeader))
+    {
+        mapped = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    } // end if
+    ::close(fd);
+    if (mapped == MAP_FAILED)
+    {
+        return false;
+    } // end if
+
+    mapping = mapped;
+    mappedBytes = static_cast<std::size_t>(info.st_size);
+    const TablebaseHeader &header = *static_cast<const TablebaseHeader *>(mapping);
+    if (std::memcmp(header.magic, TABLEBASE_MAGIC, sizeof(TABLEBASE_MAGIC)) != 0 ||
+        header.version != TABLEBASE_VERSION || header.byteOrder != TABLEBASE_BYTE_ORDER ||
+        header.rows != rows || header.cols != cols || header.inARow != inARow ||
+        header.minMarks > rows * cols || header.count > MAX_TABLEBASE_POSITIONS ||
+        mappedBytes != sizeof(TablebaseHeader) + (header.count + 31) / 32 * sizeof(std::uint64_t))
+    {
+        close();
+        return false;
+    } // end if
+
+    count = header.count;
+    lowestMarks = header.minMarks;
+    words = reinterpret_cast<const std::uint64_t *>(static_cast<const char *>(mapping) + sizeof(TablebaseHeader));
+    return true;
+#else
+    (void)path;
+    (void)rows;
+    (void)cols;
+    (void)inARow;
+    return false;
+#endif
+} // end of function open
+
+void Tablebase::close()
+{
+#if defined(TTD_HAVE_MMAP)
+    if (mapping != nullptr)
+    {
+        munmap(mapping, mappedBytes);
+    } // end if
+#endif
+    mapping = nullptr;
+    mappedBytes = 0;
+    words = nullptr;
+    count = 0;
+    lowestMarks = 0;
+} // end of function close
+
+bool Tablebase::isOpen() const
+{
+    return mapping != nullptr;
+} // end of function isOpen
+
+int Tablebase::minMarks() const
+{
+    return lowestMarks;
+} // end of function minMarks
+
+std::uint64_t Tablebase::size() const
+{
+    return count;
+} // end of function size
+
+//
+// The k-subset of rank rank in the combinatorial number system
+//
+static std::uint64_t unrankSubset(std::uint64_t rank, int k)
+{
+    std::uint64_t subset = 0;
+    for (int size = k; size > 0; --size)
+    {
+        int cell = size - 1;
+        while (BINOMIALS[cell + 1][size] <= rank)
+        {
+            ++cell;
+        } // end while
+        rank -= BINOMIALS[cell][size];
+        subset |= std::uint64_t{1} << cell;
+    } // end for
+    return subset;
+} // end of function unrankSubset
+
+//
+// Next subset of the same size in rank order, which is numeric order
+//
+static std::uint64_t nextSubset(std::uint64_t subset)
+{
+    if (subset == 0)
+    {
+        return 0;
+    } // end if
+    std::uint64_t filled = subset | (subset - 1);
+    return (filled + 1) | (((~filled & (filled + 1)) - 1) >> (std::countr_zero(subset) + 1));
+} // end of function nextSubset
+
+//
+// Spread the low bits of bits over the set cells of cells
+//
+static std::uint64_t depositBits(std::uint64_t bits, std::uint64_t cells)
+{
+    std::uint64_t result = 0;
+    for (; cells != 0 && bits != 0; cells &= cells - 1, bits >>= 1)
+    {
+        if (bits & 1)
+        {
+            result |= cells & (~cells + 1);
+        } // end if
+
+    } // end for
+    return result;
+} // end of function depositBits
+
+static int packedValue(const std::vector<std::uint64_t> &words, std::uint64_t index)
+{
+    return static_cast<int>((words[index / 32] >> (2 * (index % 32))) & 3);
+} // end of function packedValue
+
+//
+// Value of one position given the values of every position with one
+// more mark
+//
+template <typename B>
+static std::uint8_t solvePosition(B board, int minMarks, const std::vector<std::uint64_t> &words)
+{
+    bool forX = xToMove(board);
+    int state = boardState(board, forX);
+    typename B::Mask legalMoves = legalMoveMask(board);
+    if (state != static_cast<int>(State::DRAW) || legalMoves == 0)
+    {
+        return static_cast<std::uint8_t>(state > 0 ? TABLEBASE_WIN : state < 0 ? TABLEBASE_LOSS : TABLEBASE_DRAW);
+    } // end if
+
+    int best = TABLEBASE_LOSS;
+    for (; legalMoves != 0 && best != TABLEBASE_WIN; legalMoves &= legalMoves - 1)
+    {
+        B next = playMove(board, std::countr_zero(legalMoves), forX);
+        best = std::max(best, TABLEBASE_WIN - packedValue(words, tablebaseIndex(next, minMarks)));
+    } // end for
+    return static_cast<std::uint8_t>(best);
+} // end of function solvePosition
+
+template <typename B>
+bool buildTablebase(const std::string &path, int minMarks, ThreadPool &pool)
+{
+    minMarks = std::clamp(minMarks, 0, B::CELLS);
+    long double estimate = 0;
+    for (int marks = minMarks; marks <= B::CELLS; ++marks)
+    {
+        estimate += static_cast<long double>(BINOMIALS[B::CELLS][marks]) * BINOMIALS[marks][marks / 2];
+    } // end for
+    if (estimate > static_cast<long double>(MAX_TABLEBASE_POSITIONS))
+    {
+        return false;
+    } // end if
+
+    std::uint64_t total = LAYER_STARTS<B>[B::CELLS + 1] - LAYER_STARTS<B>[minMarks];
+    std::vector<std::uint64_t> words((total + 31) / 32);
+    std::vector<std::uint8_t> values;
+    for (int marks = B::CELLS; marks >= minMarks; --marks)
+    {
+        int oCount = marks / 2;
+        std::uint64_t occupiedCount = BINOMIALS[B::CELLS][marks];
+        std::uint64_t perOccupied = BINOMIALS[marks][oCount];
+        values.assign(layerSize<B>(marks), 0);
+
+        std::uint64_t slices = std::min<std::uint64_t>(occupiedCount, pool.threadCount() * SLICES_PER_THREAD);
+        pool.parallelFor(slices, [&](std::size_t slice)
+                         {
+            std::uint64_t first = occupiedCount * slice / slices;
+            std::uint64_t last = occupiedCount * (slice + 1) / slices;
+            std::uint64_t occupied = unrankSubset(first, marks);
+            for (std::uint64_t rank = first; rank < last; ++rank, occupied = nextSubset(occupied))
+            {
+                std::uint64_t oCells = (std::uint64_t{1} << oCount) - 1;
+                for (std::uint64_t oRank = 0; oRank < perOccupied; ++oRank, oCells = nextSubset(oCells))
+                {
+                    std::uint64_t o = depositBits(oCells, occupied);
+                    B board;
+                    board.x = static_cast<typename B::Mask>(occupied & ~o);
+                    board.o = static_cast<typename B::Mask>(o);
+                    values[rank * perOccupied + oRank] = solvePosition(board, minMarks, words);
+                } // end for
+            } // end for
+        });
+
+        std::uint64_t base = LAYER_STARTS<B>[marks] - LAYER_STARTS<B>[minMarks];
+        for (std::uint64_t index = 0; index < values.size(); ++index)
+        {
+            words[(base + index) / 32] |= std::uint64_t{values[index]} << (2 * ((base + index) % 32));
+        } // end for
+
+    } // end for
+
+    TablebaseHeader header{};
+    std::memcpy(header.magic, TABLEBASE_MAGIC, sizeof(TABLEBASE_MAGIC));
+    header.version = TABLEBASE_VERSION;
+    header.byteOrder = TABLEBASE_BYTE_ORDER;
+    header.rows = B::ROWS;
+    header.cols = B::COLS;
+    header.inARow = B::IN_A_ROW;
+    header.minMarks = static_cast<std::uint8_t>(minMarks);
+    header.count = total;
+
+    std::FILE *file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr)
+    {
+        return false;
+    } // end if
+
+    bool written = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+                   std::fwrite(words.data(), sizeof(std::uint64_t), words.size(), file) == words.size();
+    return std::fclose(file) == 0 && written;
+} // end of function buildTablebase
+
+template <typename B>
+Tablebase &endgameTablebase()
+{
+    static Tablebase tablebase;
+    return tablebase;
+} // end of function endgameTablebase
+
+template <typename B>
+static bool openFor(const std::string &path, const TablebaseHeader &header)
+{
+    if (header.rows != B::ROWS || header.cols != B::COLS || header.inARow != B::IN_A_ROW)
+    {
+        return false;
+    } // end if
+    return endgameTablebase<B>().open(path, B::ROWS, B::COLS, B::IN_A_ROW);
+} // end of function openFor
+
+//
+// Open a tablebase into the slot of the board size named in its header
+//
+bool loadTablebase(const std::string &path)
+{
+    TablebaseHeader header{};
+    std::FILE *file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr)
+    {
+        return false;
+    } // end if
+    bool readHeader = std::fread(&header, sizeof(header), 1, file) == 1;
+    std::fclose(file);
+    if (!readHeader)
+    {
+        return false;
+    } // end if
+
+    return openFor<Board>(path, header) || openFor<Board4x4>(path, header) ||
+           openFor<Board5x5>(path, header) || openFor<Board7x7>(path, header);
+} // end of function loadTablebase
+
+template bool buildTablebase<Board>(const std::string &path, int minMarks, ThreadPool &pool);
+template bool buildTablebase<Board4x4>(const std::string &path, int minMarks, ThreadPool &pool);
+template bool buildTablebase<Board5x5>(const std::string &path, int minMarks, ThreadPool &pool);
+template bool buildTablebase<Board7x7>(const std::string &path, int minMarks, ThreadPool &pool);
+
+template Tablebase &endgameTablebase<Board>();
+template Tablebase &endgameTablebase<Board4x4>();
+template Tablebase &endgameTablebase<Board5x5>();
+template Tablebase &endgameTablebase<Board7x7>();
@@ -0,0 +1,258 @@
+//
+// file: tablebase.hpp
+// author: Michael Brockus
+// gmail: <michaelbrockus@gmail.com>
+//
+#ifndef TABLEBASE_HPP
+#define TABLEBASE_HPP
+
+#include "search.hpp"
+#include <array>
+#include <cstdint>
+#include <string>
+
+//
+// Tablebase file layout, native byte order:
+//
+//     TablebaseHeader                 32 bytes
+//     std::uint64_t words[]           32 positions of 2 bits each
+//
+// Every position with at least minMarks marks, X having as many as O or
+// one more, has 2 bits: 0 lost, 1 drawn or 2 won for the side to move.
+// Positions are laid out by mark count, then by the combinatorial rank of
+// the occupied cells, then by the rank of the O cells among them, so the
+// index of a board is computed, never searched for.
+//
+const char TABLEBASE_MAGIC[8] = {'T', 'T', 'D', 'T', 'B', 'A', 'S', 'E'};
+const std::uint32_t TABLEBASE_VERSION = 1;
+const std::uint32_t TABLEBASE_BYTE_ORDER = 0x01020304;
+const int TABLEBASE_LOSS = 0;
+const int TABLEBASE_DRAW = 1;
+const int TABLEBASE_WIN = 2;
+
+//
+// Largest tablebase buildTablebase takes on, 4 GB of packed values
+const std::uint64_t MAX_TABLEBASE_POSITIONS = std::uint64_t{1} << 34;
+
+struct TablebaseHeader
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byteOrder;
+    std::uint8_t rows;
+    std::uint8_t cols;
+    std::uint8_t inARow;
+    std::uint8_t minMarks;
+    std::uint8_t reserved[4];
+    std::uint64_t count;
+};
+
+static_assert(sizeof(TablebaseHeader) == 32, "the header is part of the file format");
+
+//
+// n choose k for every n and k up to the biggest board
+constexpr std::array<std::array<std::uint64_t, 50>, 50> BINOMIALS = []
+{
+    std::array<std::array<std::uint64_t, 50>, 50> table{};
+    for (std::size_t n = 0; n < table.size(); ++n)
+    {
+        table[n][0] = 1;
+        for (std::size_t k = 1; k <= n; ++k)
+        {
+            table[n][k] = table[n - 1][k - 1] + (k < n ? table[n - 1][k] : 0);
+        } // end for
+
+    } // end for
+    return table;
+}();
+
+//
+// Positions with a given number of marks, X moving first
+//
+template <typename B>
+constexpr std::uint64_t layerSize(int marks)
+{
+    return BINOMIALS[B::CELLS][marks] * BINOMIALS[marks][marks / 2];
+} // end of function layerSize
+
+//
+// Index of the first position with each mark count, counted from the
+// empty board. The sums wrap on boards too big to tabulate from the
+// start, the difference between two of them stays right.
+//
+template <typename B>
+constexpr std::array<std::uint64_t, B::CELLS + 2> LAYER_STARTS = []
+{
+    std::array<std::uint64_t, B::CELLS + 2> starts{};
+    for (int marks = 0; marks <= B::CELLS; ++marks)
+    {
+        starts[marks + 1] = starts[marks] + layerSize<B>(marks);
+    } // end for
+    return starts;
+}();
+
+//
+// Whether the side to move follows from the mark count, X first
+//
+template <typename B>
+constexpr bool hasMoveParity(B board)
+{
+    int xCount = std::popcount(board.x);
+    int oCount = std::popcount(board.o);
+    return xCount == oCount || xCount == oCount + 1;
+} // end of function hasMoveParity
+
+//
+// Rank of a board among those with as many marks, the occupied cells
+// and the O cells among them each ranked in the combinatorial number
+// system
+//
+template <typename B>
+constexpr std::uint64_t layerRank(B board)
+{
+    typename B::Mask occupied = occupiedCells(board);
+    int marks = std::popcount(occupied);
+    std::uint64_t occupiedRank = 0;
+    std::uint64_t oRank = 0;
+    int seen = 0;
+    int oSeen = 0;
+    for (typename B::Mask cells = occupied; cells != 0; cells &= cells - 1)
+    {
+        int cell = std::countr_zero(cells);
+        occupiedRank += BINOMIALS[cell][++seen];
+        if (board.o & B::cellMask(cell))
+        {
+            oRank += BINOMIALS[seen - 1][++oSeen];
+        } // end if
+
+    } // end for
+    return occupiedRank * BINOMIALS[marks][marks / 2] + oRank;
+} // end of function layerRank
+
+//
+// Where a board sits in a tablebase starting at minMarks
+//
+template <typename B>
+constexpr std::uint64_t tablebaseIndex(B board, int minMarks)
+{
+    int marks = std::popcount(occupiedCells(board));
+    return LAYER_STARTS<B>[marks] - LAYER_STARTS<B>[minMarks] + layerRank(board);
+} // end of function tablebaseIndex
+
+class Tablebase
+{
+public:
+    Tablebase() = default;
+    ~Tablebase();
+
+    Tablebase(const Tablebase &) = delete;
+    Tablebase &operator=(const Tablebase &) = delete;
+
+    bool open(const std::string &path, int rows, int cols, int inARow);
+    void close();
+    bool isOpen() const;
+    int minMarks() const;
+    std::uint64_t size() const;
+
+    //
+    // TABLEBASE_LOSS, TABLEBASE_DRAW or TABLEBASE_WIN at an index below size()
+    //
+    int value(std::uint64_t index) const
+    {
+        return static_cast<int>((words[index / 32] >> (2 * (index % 32))) & 3);
+    } // end of function value
+
+    //
+    // Whether the tablebase has a value for the board
+    //
+    template <typename B>
+    bool covers(B board) const
+    {
+        return words != nullptr && hasMoveParity(board) && std::popcount(occupiedCells(board)) >= lowestMarks;
+    } // end of function covers
+
+private:
+    void *mapping = nullptr;
+    std::size_t mappedBytes = 0;
+    const std::uint64_t *words = nullptr;
+    std::uint64_t count = 0;
+    int lowestMarks = 0;
+};
+
+//
+// Perfect play for a board the tablebase covers, false for any other.
+// The tablebase keeps no distances, so a move winning at once is played
+// first and otherwise the first move in B::MOVE_ORDER keeping the value,
+// and a won or lost score is counted as if the game went to the last
+// cell, the furthest it can be. Every move costs one access per legal
+// move looked at, the value of the board a single one.
+//
+template <typename B>
+bool probeTablebase(const Tablebase &tablebase, B board, SearchResult &result)
+{
+    if (!tablebase.covers(board))
+    {
+        return false;
+    } // end if
+
+    bool forX = xToMove(board);
+    int emptyCount = B::CELLS - std::popcount(occupiedCells(board));
+    int value = tablebase.value(tablebaseIndex(board, tablebase.minMarks()));
+    result = SearchResult{};
+    result.depth = emptyCount;
+    result.score = value == TABLEBASE_WIN ? static_cast<int>(State::WIN) - emptyCount
+                   : value == TABLEBASE_LOSS ? static_cast<int>(State::LOSS) + emptyCount
+                                             : static_cast<int>(State::DRAW);
+    if (emptyCount == 0 || boardState(board, forX) != static_cast<int>(State::DRAW))
+    {
+        result.score = boardState(board, forX);
+        return true;
+    } // end if
+
+    typename B::Mask legalMoves = legalMoveMask(board);
+    for (int cell : B::MOVE_ORDER)
+    {
+        if ((legalMoves & B::cellMask(cell)) == 0)
+        {
+            continue;
+        } // end if
+
+        B next = playMove(board, cell, forX);
+        if (boardState(next, forX) == static_cast<int>(State::WIN))
+        {
+            result.move = cell;
+            result.score = static_cast<int>(State::WIN) - 1;
+            break;
+        } // end if
+
+        if (result.move == NO_MOVE && TABLEBASE_WIN - tablebase.value(tablebaseIndex(next, tablebase.minMarks())) == value)
+        {
+            result.move = cell;
+        } // end if
+
+    } // end for
+
+    result.line.moves[0] = static_cast<std::int8_t>(result.move);
+    result.line.length = 1;
+    return true;
+} // end of function probeTablebase
+
+//
+// Solve every position with at least minMarks marks by retrograde
+// analysis and write the tablebase, false when it would be bigger than
+// MAX_TABLEBASE_POSITIONS or the file cannot be written
+//
+template <typename B>
+bool buildTablebase(const std::string &path, int minMarks, ThreadPool &pool);
+
+//
+// Tablebase consulted by findBestMove for each board size, empty until
+// loadTablebase opens a file made for that size. Load tablebases at
+// startup, before any search runs.
+//
+template <typename B>
+Tablebase &endgameTablebase();
+
+bool loadTablebase(const std::string &path);
+
+#endif // end of TABLEBASE_HPP
@@ -0,0 +1,157 @@
+//
+// file: thread_pool.cpp
+// author: Michael Brockus
+// gmail: <michaelbrockus@gmail.com>
+//
+#include "thread_pool.hpp"
+#include <algorithm>
+
+//
+// Set while this thread runs a loop body, a nested loop then runs inline
+static thread_local bool insideLoop = false;
+
+//
+// Start the worker threads, a count of 0 uses every hardware thread
+//
+ThreadPool::ThreadPool(unsigned threadCount)
+{
+    if (threadCount == 0)
+    {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    } // end if
+
+    for (unsigned index = 0; index < threadCount; ++index)
+    {
+        queues.push_back(std::make_unique<WorkQueue>());
+    } // end for
+
+    //
+    // Queue 0 belongs to whoever calls parallelFor
+    for (unsigned index = 1; index < threadCount; ++index)
+    {
+        workers.emplace_back(&ThreadPool::workerLoop, this, index);
+    } // end for
+} // end of constructor
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> guard(sleepLock);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    } // end for
+} // end of destructor
+
+unsigned ThreadPool::threadCount() const
+{
+    return static_cast<unsigned>(queues.size());
+} // end of function threadCount
+
+//
+// Take from the front of our own queue, else steal from the back of another
+//
+bool ThreadPool::takeTask(unsigned self, Task &task)
+{
+    for (std::size_t offset = 0; offset < queues.size(); ++offset)
+    {
+        std::size_t owner = (self + offset) % queues.size();
+        WorkQueue &queue = *queues[owner];
+        std::lock_guard<std::mutex> guard(queue.lock);
+        if (queue.front == queue.back)
+        {
+            continue;
+        } // end if
+
+        std::size_t step = offset == 0 ? queue.front++ : --queue.back;
+        task.job = queue.job;
+        task.index = owner + step * queues.size();
+        queued.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    } // end for
+
+    return false;
+} // end of function takeTask
+
+void ThreadPool::runTask(const Task &task)
+{
+    insideLoop = true;
+    (*task.job->body)(task.index);
+    insideLoop = false;
+    task.job->remaining.fetch_sub(1, std::memory_order_acq_rel);
+} // end of function runTask
+
+void ThreadPool::workerLoop(unsigned self)
+{
+    while (true)
+    {
+        Task task;
+        if (takeTask(self, task))
+        {
+            runTask(task);
+            continue;
+        } // end if
+
+        std::unique_lock<std::mutex> guard(sleepLock);
+        wakeUp.wait(guard, [this]
+                    { return stopping || queued.load(std::memory_order_relaxed) > 0; });
+        if (stopping)
+        {
+            return;
+        } // end if
+
+    } // end while
+} // end of function workerLoop
+
+//
+// Run body(0) ... body(count - 1) across the pool and wait for all of them.
+// Iterations are dealt out round robin, so each thread starts on its own
+// share and only steals once that runs dry.
+//
+void ThreadPool::parallelFor(std::size_t count, LoopBody body)
+{
+    if (insideLoop)
+    {
+        for (std::size_t index = 0; index < count; ++index)
+        {
+            body(index);
+        } // end for
+        return;
+    } // end if
+
+    std::lock_guard<std::mutex> loopGuard(loopLock);
+    Job job;
+    job.body = &body;
+    job.remaining.store(count, std::memory_order_relaxed);
+    for (std::size_t owner = 0; owner < queues.size(); ++owner)
+    {
+        WorkQueue &queue = *queues[owner];
+        std::lock_guard<std::mutex> guard(queue.lock);
+        queue.job = &job;
+        queue.front = 0;
+        queue.back = count > owner ? (count - owner + queues.size() - 1) / queues.size() : 0;
+    } // end for
+
+    {
+        std::lock_guard<std::mutex> guard(sleepLock);
+        queued.fetch_add(count, std::memory_order_relaxed);
+    }
+    wakeUp.notify_all();
+
+    while (job.remaining.load(std::memory_order_acquire) != 0)
+    {
+        Task task;
+        if (takeTask(0, task))
+        {
+            runTask(task);
+        } // end if
+        else
+        {
+            std::this_thread::yield();
+        } // end else
+
+    } // end while
+} // end of function parallelFor
@@ -0,0 +1,106 @@
+//
+// file: thread_pool.hpp
+// author: Michael Brockus
+// gmail: <michaelbrockus@gmail.com>
+//
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+//
+// Non-owning reference to a loop body, so handing a lambda to the pool
+// never allocates the way a std::function can
+//
+class LoopBody
+{
+public:
+    template <typename F>
+        requires(!std::is_same_v<std::remove_cv_t<F>, LoopBody>)
+    LoopBody(F &body) : object(&body), call([](void *object, std::size_t index)
+                                           { (*static_cast<F *>(object))(index); })
+    {
+    } // end of constructor
+
+    void operator()(std::size_t index) const
+    {
+        call(object, index);
+    } // end of function operator()
+
+private:
+    void *object;
+    void (*call)(void *, std::size_t);
+};
+
+//
+// Work-stealing thread pool. Every thread owns a queue and takes work
+// from its front, an idle thread steals from the back of another queue.
+// The thread calling parallelFor counts as one of the threads and works
+// on the loop until it is done, so a pool of one thread runs everything
+// on the caller, in order. Queues are index ranges, so running a loop
+// allocates nothing. One loop runs at a time, a parallelFor called from
+// inside a loop body runs its loop on the calling thread.
+//
+class ThreadPool
+{
+public:
+    explicit ThreadPool(unsigned threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    unsigned threadCount() const;
+    void parallelFor(std::size_t count, LoopBody body);
+
+    template <typename F>
+    void parallelFor(std::size_t count, F &&body)
+    {
+        parallelFor(count, LoopBody(body));
+    } // end of function parallelFor
+
+private:
+    struct Job
+    {
+        const LoopBody *body = nullptr;
+        std::atomic<std::size_t> remaining{0};
+    };
+
+    struct Task
+    {
+        Job *job = nullptr;
+        std::size_t index = 0;
+    };
+
+    //
+    // Queue t holds the loop indices t, t + threads, t + 2 * threads, ...
+    // as the range of steps [front, back).
+    struct WorkQueue
+    {
+        std::mutex lock;
+        Job *job = nullptr;
+        std::size_t front = 0;
+        std::size_t back = 0;
+    };
+
+    bool takeTask(unsigned self, Task &task);
+    void runTask(const Task &task);
+    void workerLoop(unsigned self);
+
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    std::vector<std::thread> workers;
+    std::mutex loopLock;
+    std::mutex sleepLock;
+    std::condition_variable wakeUp;
+    std::atomic<std::size_t> queued{0};
+    bool stopping = false;
+};
+
+#endif // end of THREAD_POOL_HPP
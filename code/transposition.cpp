@@ -0,0 +1,101 @@
+//
+// file: transposition.cpp
+// author: Michael Brockus
+// gmail: <michaelbrockus@gmail.com>
+//
+#include "transposition.hpp"
+#include <bit>
+
+//
+// Packed slot layout: bits 0-15 score, 16-23 best move, 24-31 depth,
+// 32-39 bound, bit 40 set once the slot has been written and 41-63 the
+// search generation that wrote it. The generation wraps after 2^23
+// searches, about 8 million on one table, and only an entry last written
+// exactly that many searches before would then count as current again.
+const std::uint64_t USED_BIT = 1ull << 40;
+const int GENERATION_SHIFT = 41;
+const std::uint64_t GENERATION_MASK = (1ull << 23) - 1;
+
+//
+// Round the size up to a power of two so the index is a single AND
+//
+TranspositionTable::TranspositionTable(std::size_t minEntries)
+    : slots(std::bit_ceil(minEntries)),
+      indexMask(std::bit_ceil(minEntries) - 1)
+{
+} // end of constructor
+
+//
+// Look up a position, false when it has not been stored
+//
+bool TranspositionTable::probe(std::uint64_t key, TableEntry &entry) const
+{
+    const Slot &slot = slots[key & indexMask];
+    std::uint64_t data = slot.data.load(std::memory_order_relaxed);
+    std::uint64_t check = slot.check.load(std::memory_order_relaxed);
+    if ((data & USED_BIT) == 0 || (check ^ data) != key)
+    {
+        return false;
+    } // end if
+
+    entry.key = key;
+    entry.score = static_cast<std::int16_t>(data & 0xFFFF);
+    entry.bestMove = static_cast<std::int8_t>((data >> 16) & 0xFF);
+    entry.depth = static_cast<std::int8_t>((data >> 24) & 0xFF);
+    entry.bound = static_cast<Bound>((data >> 32) & 0xFF);
+    return true;
+} // end of function probe
+
+//
+// Store a search result. A slot holding another position is only taken
+// over when it was written by an earlier search or searched less deep, so
+// deep results of the current search survive and those of the searches
+// before it make way as the table fills, oldest first in effect.
+//
+void TranspositionTable::store(std::uint64_t key, int score, int bestMove, Bound bound, int depth)
+{
+    std::uint64_t current = generation.load(std::memory_order_relaxed);
+    Slot &slot = slots[key & indexMask];
+    std::uint64_t held = slot.data.load(std::memory_order_relaxed);
+    if ((held & USED_BIT) != 0 && (slot.check.load(std::memory_order_relaxed) ^ held) != key &&
+        (held >> GENERATION_SHIFT) == current && static_cast<std::int8_t>((held >> 24) & 0xFF) > depth)
+    {
+        return;
+    } // end if
+
+    std::uint64_t data = static_cast<std::uint16_t>(score) |
+                         static_cast<std::uint64_t>(static_cast<std::uint8_t>(bestMove)) << 16 |
+                         static_cast<std::uint64_t>(static_cast<std::uint8_t>(depth)) << 24 |
+                         static_cast<std::uint64_t>(bound) << 32 |
+                         USED_BIT | current << GENERATION_SHIFT;
+    slot.check.store(key ^ data, std::memory_order_relaxed);
+    slot.data.store(data, std::memory_order_relaxed);
+} // end of function store
+
+//
+// Start a new search. What earlier searches stored stays readable but is
+// the first to be replaced.
+//
+void TranspositionTable::newSearch()
+{
+    generation.store((generation.load(std::memory_order_relaxed) + 1) & GENERATION_MASK, std::memory_order_relaxed);
+} // end of function newSearch
+
+void TranspositionTable::clear()
+{
+    for (Slot &slot : slots)
+    {
+        slot.check.store(0, std::memory_order_relaxed);
+        slot.data.store(0, std::memory_order_relaxed);
+    } // end for
+} // end of function clear
+
+std::size_t TranspositionTable::size() const
+{
+    return slots.size();
+} // end of function size
+
+std::size_t TranspositionTable::memoryBytes() const
+{
+    return slots.size() * sizeof(Slot);
+} // end of function memoryBytes
@@ -0,0 +1,75 @@
+//
+// file: transposition.hpp
+// author: Michael Brockus
+// gmail: <michaelbrockus@gmail.com>
+//
+#ifndef TRANSPOSITION_HPP
+#define TRANSPOSITION_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//
+// How a stored score relates to the true value of the position
+enum class Bound : std::uint8_t
+{
+    EXACT,
+    LOWER,
+    UPPER
+};
+
+struct TableEntry
+{
+    std::uint64_t key = 0;
+    std::int16_t score = 0;
+    std::int8_t bestMove = -1;
+    std::int8_t depth = 0;
+    Bound bound = Bound::EXACT;
+};
+
+//
+// Memory taken by each entry of a table
+const std::size_t TABLE_SLOT_BYTES = 16;
+
+//
+// Fixed size table of search results indexed by position key. Keys smaller
+// than the table size never collide, so the base 3 key of a 3x3 board
+// gets a perfect table.
+//
+// Any number of threads may probe and store at once. Each slot keeps the
+// packed entry next to the key XOR-ed with it, so a slot torn by two
+// racing stores no longer matches its key and reads as a miss.
+//
+// The table outlives single searches. Calling newSearch before each one
+// ages what is stored, which keeps it usable while letting the new search
+// replace it first.
+//
+class TranspositionTable
+{
+public:
+    explicit TranspositionTable(std::size_t minEntries);
+
+    bool probe(std::uint64_t key, TableEntry &entry) const;
+    void store(std::uint64_t key, int score, int bestMove, Bound bound, int depth);
+    void clear();
+    void newSearch();
+    std::size_t size() const;
+    std::size_t memoryBytes() const;
+
+private:
+    struct Slot
+    {
+        std::atomic<std::uint64_t> check{0};
+        std::atomic<std::uint64_t> data{0};
+    };
+
+    static_assert(sizeof(Slot) == TABLE_SLOT_BYTES, "memory caps are counted in slots");
+
+    std::vector<Slot> slots;
+    std::size_t indexMask;
+    std::atomic<std::uint64_t> generation{0};
+};
+
+#endif // end of TRANSPOSITION_HPP
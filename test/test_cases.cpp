@@ -9,10 +9,66 @@
 // project since its important to test once implementation against a set
 // of common test cases
 //
+#include "batch.hpp"
+#include "book.hpp"
+#include "engine.hpp"
 #include "game.hpp"
+#include "mcts.hpp"
+#include "perft.hpp"
+#include "ponder.hpp"
+#include "position.hpp"
+#include "server.hpp"
+#include "simd_kernel.hpp"
+#include "solved.hpp"
+#include "symmetry.hpp"
+#include "tablebase.hpp"
+#include "transposition.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
 #include <iostream>
+#include <new>
+#include <thread>
 #include <unity.h>
 
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+
+//
+// Every heap allocation of the test program is counted so a test can
+// check a call made none
+//
+static std::atomic<std::uint64_t> allocationCount{0};
+
+void *operator new(std::size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void *memory = std::malloc(size == 0 ? 1 : size))
+    {
+        return memory;
+    } // end if
+    throw std::bad_alloc();
+} // end of function operator new
+
+//
+// Kept out of line, once inlined at -O3 GCC pairs the free with the new
+// expression at the call site and reports a mismatched deallocation
+//
+__attribute__((noinline)) void operator delete(void *memory) noexcept
+{
+    std::free(memory);
+} // end of function operator delete
+
+__attribute__((noinline)) void operator delete(void *memory, std::size_t) noexcept
+{
+    std::free(memory);
+} // end of function operator delete
+
 //
 //  project setup teardown functions if needed
 //
@@ -605,6 +661,1313 @@ static void test_checkGameIsDone()
     TEST_ASSERT_EQUAL(true, gameIsDone(board));
 } // end of test case
 
+///////////////////////////////////////////////////////////////////////////////
+// test_checkBitboardAdapters:
+//
+// Verify the char grid and the bitboard agree with each other.
+//
+static void test_checkBitboardAdapters()
+{
+    std::array<std::array<char, 3>, 3> board = {{{PLAYER_MARKER, EMPTY_SPACE, AI_MARKER},
+                                                 {EMPTY_SPACE, AI_MARKER, EMPTY_SPACE},
+                                                 {PLAYER_MARKER, EMPTY_SPACE, PLAYER_MARKER}}};
+
+    Board bits = toBoard(board);
+    TEST_ASSERT_EQUAL(0x141, bits.x);
+    TEST_ASSERT_EQUAL(0x014, bits.o);
+    TEST_ASSERT_EQUAL(0x0AA, legalMoveMask(bits));
+    TEST_ASSERT_EQUAL(false, xToMove(bits));
+
+    //
+    // Every winning line is detected from its mask and its positions
+    for (Mask line : WIN_MASKS)
+    {
+        TEST_ASSERT_EQUAL(true, hasWinningLine(line));
+        TEST_ASSERT_EQUAL(true, gameIsWon(toPositions(line)));
+        TEST_ASSERT_EQUAL(line, toMask(toPositions(line)));
+    }
+
+    TEST_ASSERT_EQUAL(false, hasWinningLine(bits.x));
+    TEST_ASSERT_EQUAL(true, hasWinningLine(playMove(bits, cellIndex(2, 1), true).x));
+    TEST_ASSERT_EQUAL(0, toMask({{-1, 0}, {3, 3}}));
+} // end of test case
+
+///////////////////////////////////////////////////////////////////////////////
+// test_checkTranspositionTable:
+//
+// Verify position keys are compact and the table hands back what was stored.
+//
+static void test_checkTranspositionTable()
+{
+    Board board;
+    TEST_ASSERT_EQUAL(0, positionKey(board));
+
+    board.o = FULL_BOARD;
+    TEST_ASSERT_EQUAL(POSITION_COUNT - 1, positionKey(board));
+
+    board = Board{cellMask(0), cellMask(1)};
+    TEST_ASSERT_EQUAL(1 + 2 * 3, positionKey(board));
+
+    TranspositionTable table(POSITION_COUNT);
+    TableEntry entry;
+    TEST_ASSERT_EQUAL(false, table.probe(positionKey(board), entry));
+
+    table.store(positionKey(board), static_cast<int>(State::LOSS), 4, Bound::UPPER, 7);
+    TEST_ASSERT_EQUAL(true, table.probe(positionKey(board), entry));
+    TEST_ASSERT_EQUAL(static_cast<int>(State::LOSS), entry.score);
+    TEST_ASSERT_EQUAL(4, entry.bestMove);
+    TEST_ASSERT_EQUAL(7, entry.depth);
+    TEST_ASSERT(entry.bound == Bound::UPPER);
+    TEST_ASSERT_EQUAL(false, table.probe(positionKey(board) + 1, entry));
+
+    //
+    // No move is stored for terminal positions
+    table.store(0, static_cast<int>(State::DRAW), NO_MOVE, Bound::EXACT, 0);
+    TEST_ASSERT_EQUAL(true, table.probe(0, entry));
+    TEST_ASSERT_EQUAL(NO_MOVE, entry.bestMove);
+
+    table.clear();
+    TEST_ASSERT_EQUAL(false, table.probe(positionKey(board), entry));
+} // end of test case
+
+///////////////////////////////////////////////////////////////////////////////
+// test_checkSymmetry:
+//
+// Verify every orientation of a board shares one canonical form and moves
+// survive the trip to the canonical board and back.
+//
+static void test_checkSymmetry()
+{
+    //
+    // X O -
+    // - - -
+    // - - X
+    Board board{static_cast<Mask>(cellMask(0) | cellMask(8)), cellMask(1)};
+    CanonicalBoard canonical = canonicalize(board);
+
+    for (int symmetry = 0; symmetry < SYMMETRY_COUNT; ++symmetry)
+    {
+        Board image = transformBoard(board, symmetry);
+        CanonicalBoard other = canonicalize(image);
+        TEST_ASSERT_EQUAL(positionKey(canonical.board), positionKey(other.board));
+
+        //
+        // Every winning line is still a winning line
+        for (Mask line : WIN_MASKS)
+        {
+            TEST_ASSERT_EQUAL(true, hasWinningLine(SYMMETRY_MASKS[symmetry][line]));
+        }
+
+        for (int cell = 0; cell < BOARD_CELLS; ++cell)
+        {
+            TEST_ASSERT_EQUAL(cell, moveFromCanonical(moveToCanonical(cell, symmetry), symmetry));
+            TEST_ASSERT_EQUAL(cell, transformCell(transformCell(cell, symmetry), inverseSymmetry(symmetry)));
+        }
+    }
+
+    //
+    // Only three first moves are different up to symmetry
+    int firstMoveKeys[BOARD_CELLS];
+    int distinct = 0;
+    for (int cell = 0; cell < BOARD_CELLS; ++cell)
+    {
+        int key = positionKey(canonicalize(Board{cellMask(cell), 0}).board);
+        bool seen = false;
+        for (int index = 0; index < distinct; ++index)
+        {
+            seen = seen || (firstMoveKeys[index] == key);
+        }
+        if (!seen)
+        {
+            firstMoveKeys[distinct++] = key;
+        }
+    }
+    TEST_ASSERT_EQUAL(3, distinct);
+} // end of test case
+
+///////////////////////////////////////////////////////////////////////////////
+// test_checkAlphaBetaSearch:
+//
+// Verify the pruned search agrees with the reference minimax and visits
+// far fewer nodes doing it.
+//
+static void test_checkAlphaBetaSearch()
+{
+    TranspositionTable table(POSITION_COUNT);
+
+    //
+    // Empty board is a draw with perfect play
+    SearchResult reference = minimaxSearch(Board{});
+    SearchResult pruned = alphaBetaSearch(Board{}, table);
+    std::cout << "empty board nodes: minimax " << reference.nodes << ", alpha-beta " << pruned.nodes << std::endl;
+    TEST_ASSERT_EQUAL(static_cast<int>(State::DRAW), reference.score);
+    TEST_ASSERT_EQUAL(static_cast<int>(State::DRAW), pruned.score);
+    TEST_ASSERT(pruned.nodes * 10 < reference.nodes);
+
+    //
+    // Center goes first in the move ordering
+    TEST_ASSERT_EQUAL(4, pruned.move);
+
+    //
+    // A second search of the same board is answered from the table
+    pruned = alphaBetaSearch(Board{}, table);
+    TEST_ASSERT_EQUAL(1, pruned.nodes);
+    TEST_ASSERT_EQUAL(4, pruned.move);
+
+    //
+    // X X -
+    // O O -
+    // - - -
+    // X to move wins right away
+    Board board{static_cast<Mask>(cellMask(0) | cellMask(1)), static_cast<Mask>(cellMask(3) | cellMask(4))};
+    table.clear();
+    reference = minimaxSearch(board);
+    pruned = alphaBetaSearch(board, table);
+    TEST_ASSERT_EQUAL(static_cast<int>(State::WIN) - 1, reference.score);
+    TEST_ASSERT_EQUAL(static_cast<int>(State::WIN) - 1, pruned.score);
+    TEST_ASSERT_EQUAL(2, pruned.move);
+} // end of test case
+
+///////////////////////////////////////////////////////////////////////////////
+// test_checkSolvedTable:
+//
+// Verify the compile time solution agrees with the reference minimax on
+// every position reachable from the empty board.
+//
+static int checkSolvedFrom(Board board)
+{
+    SolvedEntry entry = lookupSolved(board);
+    int mismatches = (entry.reachable && entry.score == minimaxSearch(board).score) ? 0 : 1;
+    if (entry.move == NO_MOVE)
+    {
+        return mismatches;
+    }
+
+    //
+    // The chosen move is legal and keeps the value of the position
+    mismatches += (legalMoveMask(board) & cellMask(entry.move)) ? 0 : 1;
+    mismatches += (scoreBeforeMove(lookupSolved(playMove(board, entry.move, xToMove(board))).score) == entry.score) ? 0 : 1;
+
+    for (Mask moves = legalMoveMask(board); moves != 0; moves &= moves - 1)
+    {
+        mismatches += checkSolvedFrom(playMove(board, std::countr_zero(moves), xToMove(board)));
+    }
+    return mismatches;
+}
+
+static void test_checkSolvedTable()
+{
+    TEST_ASSERT_EQUAL(5478, solvedReachableCount());
+    TEST_ASSERT_EQUAL(static_cast<int>(State::DRAW), lookupSolved(Board{}).score);
+    TEST_ASSERT_EQUAL(4, lookupSolved(Board{}).move);
+    TEST_ASSERT_EQUAL(0, checkSolvedFrom(Board{}));
+
+    //
+    // X X X
+    // O O -
+    // - - -
+    // Game over, nothing left to play
+    SolvedEntry entry = lookupSolved(Board{0x007, 0x018});
+    TEST_ASSERT_EQUAL(NO_MOVE, entry.move);
+    TEST_ASSERT_EQUAL(static_cast<int>(State::LOSS), entry.score);
+} // end of test case
+
+///////////////////////////////////////////////////////////////////////////////
+// test_checkGeneralizedBoards:
+//
+// Verify win lines and move ordering are generated for every board size
+// and the search plays on boards bigger than 3x3.
+//
+static void test_checkGeneralizedBoards()
+{
+    TEST_ASSERT_EQUAL(8, Board::LINE_COUNT);
+    TEST_ASSERT_EQUAL(10, Board4x4::LINE_COUNT);
+    TEST_ASSERT_EQUAL(28, Board5x5::LINE_COUNT);
+    TEST_ASSERT_EQUAL(60, Board7x7::LINE_COUNT);
+    TEST_ASSERT_EQUAL(64, sizeof(GameBoard<8, 8, 5>::Mask) * 8);
+
+    const int classicOrder[BOARD_CELLS] = {4, 0, 2, 6, 8, 1, 3, 5, 7};
+    for (int index = 0; index < BOARD_CELLS; ++index)
+    {
+        TEST_ASSERT_EQUAL(classicOrder[index], Board::MOVE_ORDER[index]);
+    }
+
+    //
+    // Center cells come first on a 7x7 board
+    TEST_ASSERT_EQUAL(Board7x7::cellIndex(3, 3), Board7x7::MOVE_ORDER[0]);
+
+    //
+    // Every cell of a winning line on 7x7 is K cells long
+    for (Board7x7::Mask line : Board7x7::LINES)
+    {
+        TEST_ASSERT_EQUAL(5, std::popcount(line));
+    }
+
+    //
+    // X X X -
+    // O O O -
+    // X O X O
+    // O X - -
+    // X to move wins at (0, 3), O would have won at (1, 3) or (0, 3)
+    Board4x4 board;
+    board.x = Board4x4::cellMask(0) | Board4x4::cellMask(1) | Board4x4::cellMask(2) |
+              Board4x4::cellMask(8) | Board4x4::cellMask(10) | Board4x4::cellMask(13);
+    board.o = Board4x4::cellMask(4) | Board4x4::cellMask(5) | Board4x4::cellMask(6) |
+              Board4x4::cellMask(9) | Board4x4::cellMask(11) | Board4x4::cellMask(12);
+    TEST_ASSERT_EQUAL(true, xToMove(board));
+
+    TranspositionTable table(1024);
+    SearchResult result = alphaBetaSearch(board, table);
+    TEST_ASSERT_EQUAL(static_cast<int>(State::WIN) - 1, result.score);
+    TEST_ASSERT_EQUAL(Board4x4::cellIndex(0, 3), result.move);
+
+    board = playMove(board, Board4x4::cellIndex(3, 3), true);
+    result = alphaBetaSearch(board, table);
+    TEST_ASSERT_EQUAL(static_cast<int>(State::WIN) - 1, result.score);
+    TEST_ASSERT(result.move == Board4x4::cellIndex(1, 3) || result.move == Board4x4::cellIndex(0, 3));
+} // end of test case
+
+///////////////////////////////////////////////////////////////////////////////
+// test_checkIterativeDeepening:
+//
+// Verify the budgeted search solves small boards and always hands back a
+// legal move on big boards, within its node and time budgets.
+//
+static void test_checkIterativeDeepening()
+{
+    //
+    // With no budget the 3x3 board is solved all the way
+    TranspositionTable table(POSITION_COUNT);
+    SearchResult result = iterativeDeepeningSearch(Board{}, SearchLimits{}, table);
+    TEST_ASSERT_EQUAL(static_cast<int>(State::DRAW), result.score);
+    TEST_ASSERT_EQUAL(BOARD_CELLS, result.depth);
+    TEST_ASSERT_EQUAL(4, result.move);
+
+    //
+    // A node budget is never exceeded and a move is always returned
+    SearchLimits limits;
+    limits.maxNodes = 5000;
+    result = findBestMove(Board7x7{}, limits);
+    TEST_ASSERT(result.nodes <= limits.maxNodes);
+    TEST_ASSERT(result.depth >= 1);
+    TEST_ASSERT(result.move != NO_MOVE);
+
+    limits.maxNodes = 1;
+    result = findBestMove(Board7x7{}, limits);
+    TEST_ASSERT_EQUAL(0, result.depth);
+    TEST_ASSERT_EQUAL(Board7x7::MOVE_ORDER[0], result.move);
+
+    //
+    // A deadline stops a search that would never finish
+    limits = SearchLimits{};
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    limits.deadline = start + std::chrono::milliseconds(50);
+    result = findBestMove(Board5x5{}, limits);
+    std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "5x5 depth " << result.depth << " in " << result.nodes << " nodes" << std::endl;
+    TEST_ASSERT(elapsed < std::chrono::milliseconds(500));
+    TEST_ASSERT(result.depth >= 1);
+    TEST_ASSERT(result.move != NO_MOVE);
+
+    //
+    // A depth cap stops early too
+    limits = SearchLimits{};
+    limits.maxDepth = 2;
+    result = findBestMove(Board4x4{}, limits);
+    TEST_ASSERT_EQUAL(2, result.depth);
+
+    //
+    // A finished game answers with its result, here lost for O to move
+    result = iterativeDeepeningSearch(Board{0x007, 0x018}, SearchLimits{}, table);
+    TEST_ASSERT_EQUAL(NO_MOVE, result.move);
+    TEST_ASSERT_EQUAL(static_cast<int>(State::LOSS), result.score);
+} // end of test case
+
+///////////////////////////////////////////////////////////////////////////////
+// test_checkParallelSearch:
+//
+// Verify the pool runs every iteration once and the parallel search finds
+// the same result as the serial one, move for move with a single thread.
+//
+static void test_checkParallelSearch()
+{
+    ThreadPool pool(4);
+    TEST_ASSERT_EQUAL(4, pool.threadCount());
+
+    std::vector<std::atomic<int>> hits(1000);
+    pool.parallelFor(hits.size(), [&](std::size_t index)
+                     { hits[index].fetch_add(1); });
+    for (std::atomic<int> &hit : hits)
+    {
+        TEST_ASSERT_EQUAL(1, hit.load());
+    }
+
+    SearchLimits limits;
+    limits.maxDepth = 5;
+    Board5x5 board = playMove(Board5x5{}, Board5x5::cellIndex(2, 2), true);
+
+    TranspositionTable serialTable(1 << 16);
+    SearchResult serial = iterativeDeepeningSearch(board, limits, serialTable);
+
+    ThreadPool single(1);
+    TranspositionTable singleTable(1 << 16);
+    SearchResult one = parallelSearch(board, limits, singleTable, single);
+    TEST_ASSERT_EQUAL(serial.score, one.score);
+    TEST_ASSERT_EQUAL(serial.move, one.move);
+    TEST_ASSERT_EQUAL(serial.depth, one.depth);
+
+    //
+    // With more threads the value of a solved position is the same
+    // X O X O
+    // - - - -
+    // O X O X
+    // - - - -
+    Board4x4 endgame;
+    endgame.x = Board4x4::cellMask(0) | Board4x4::cellMask(2) | Board4x4::cellMask(9) | Board4x4::cellMask(11);
+    endgame.o = Board4x4::cellMask(1) | Board4x4::cellMask(3) | Board4x4::cellMask(8) | Board4x4::cellMask(10);
+    TranspositionTable referenceTable(1 << 16);
+    SearchResult reference = alphaBetaSearch(endgame, referenceTable);
+    TranspositionTable sharedTable(1 << 16);
+    SearchResult many = parallelSearch(endgame, SearchLimits{}, sharedTable, pool);
+    TEST_ASSERT_EQUAL(reference.score, many.score);
+    TEST_ASSERT(legalMoveMask(endgame) & Board4x4::cellMask(many.move));
+
+    //
+    // The whole 3x3 game is still a draw
+    TranspositionTable classicTable(POSITION_COUNT);
+    TEST_ASSERT_EQUAL(static_cast<int>(State::DRAW), parallelSearch(Board{}, SearchLimits{}, classicTable, pool).score);
+} // end of test case
+
+///////////////////////////////////////////////////////////////////////////////
+// test_checkFindBestMoves:
+//
+// Verify the batch entry points give the same moves as one call per board.
+//
+static void test_checkFindBestMoves()
+{
+    std::vector<std::array<std::array<char, 3>, 3>> boards;
+    std::array<std::array<char, 3>, 3> board = {{{EMPTY_SPACE, EMPTY_SPACE, EMPTY_SPACE},
+                                                 {EMPTY_SPACE, EMPTY_SPACE, EMPTY_SPACE},
+                                                 {EMPTY_SPACE, EMPTY_SPACE, EMPTY_SPACE}}};
+
+    //
+    // Play a whole game, keeping every board along the way, twice over
+    // so the batch spans more than one block.
+    for (int round = 0; round < 60; ++round)
+    {
+        boards.push_back(board);
+        std::pair<int, int> move = findBestMove(board);
+        if (move.first == NO_MOVE)
+        {
+            board = {{{EMPTY_SPACE, EMPTY_SPACE, EMPTY_SPACE},
+                      {EMPTY_SPACE, EMPTY_SPACE, EMPTY_SPACE},
+                      {EMPTY_SPACE, EMPTY_SPACE, EMPTY_SPACE}}};
+            board[round % 3][(round / 3) % 3] = PLAYER_MARKER;
+            continue;
+        }
+        board[move.first][move.second] = ((round & 1) ? AI_MARKER : PLAYER_MARKER);
+    }
+    boards.insert(boards.end(), boards.begin(), boards.end());
+    boards.insert(boards.end(), boards.begin(), boards.end());
+    boards.insert(boards.end(), boards.begin(), boards.end());
+
+    std::vector<std::pair<int, int>> moves(boards.size());
+    findBestMoves(boards, moves);
+    for (std::size_t index = 0; index < boards.size(); ++index)
+    {
+        TEST_ASSERT(findBestMove(boards[index]) == moves[index]);
+    }
+
+    //
+    // Bigger boards, with copies of the same position in the batch
+    std::vector<Board4x4> bigBoards;
+    for (int cell = 0; cell < Board4x4::CELLS; ++cell)
+    {
+        bigBoards.push_back(playMove(Board4x4{}, cell, true));
+        bigBoards.push_back(playMove(Board4x4{}, Board4x4::CELLS - 1 - cell, true));
+    }
+
+    SearchLimits limits;
+    limits.maxDepth = 3;
+    ThreadPool pool(2);
+    std::vector<SearchResult> results(bigBoards.size());
+    findBestMoves<Board4x4>(bigBoards, results, limits, pool);
+    for (std::size_t index = 0; index < bigBoards.size(); ++index)
+    {
+        TEST_ASSERT_EQUAL(3, results[index].depth);
+        TEST_ASSERT(legalMoveMask(bigBoards[index]) & Board4x4::cellMask(results[index].move));
+    }
+
+    //
+    // Copies of a position share one search
+    for (int cell = 0; cell < Board4x4::CELLS; ++cell)
+    {
+        const SearchResult &first = results[2 * cell];
+        const SearchResult &copy = results[2 * (Board4x4::CELLS - 1 - cell) + 1];
+        TEST_ASSERT_EQUAL(first.move, copy.move);
+        TEST_ASSERT_EQUAL(first.score, copy.score);
+        TEST_ASSERT_EQUAL(first.nodes, copy.nodes);
+    }
+} // end of test case
+
+///////////////////////////////////////////////////////////////////////////////
+// test_checkSimdKernel:
+//
+// Verify every kernel this CPU can run classifies boards like the scalar one.
+//
+static void test_checkSimdKernel()
+{
+    //
+    // Every 3x3 board with a legal mark count, plus some odd ones out
+    std::vector<std::uint16_t> xs;
+    std::vector<std::uint16_t> os;
+    for (std::uint32_t x = 0; x <= FULL_BOARD; ++x)
+    {
+        for (std::uint32_t o = 0; o <= FULL_BOARD; o += 7)
+        {
+            if ((x & o) == 0)
+            {
+                xs.push_back(static_cast<std::uint16_t>(x));
+                os.push_back(static_cast<std::uint16_t>(o));
+            }
+        }
+    }
+    xs.push_back(0x007);
+    os.push_back(0x1C0);
+
+    std::vector<Outcome> scalar(xs.size());
+    classifyBoards(xs, os, scalar, WIN_MASKS, FULL_BOARD, SimdLevel::SCALAR);
+    for (std::size_t index = 0; index < xs.size(); ++index)
+    {
+        Board board{xs[index], os[index]};
+        Outcome expected = Outcome::ONGOING;
+        if (hasWinningLine(board.x))
+        {
+            expected = Outcome::X_WINS;
+        }
+        else if (hasWinningLine(board.o))
+        {
+            expected = Outcome::O_WINS;
+        }
+        else if (boardFull(board))
+        {
+            expected = Outcome::DRAW;
+        }
+        TEST_ASSERT(expected == scalar[index]);
+    }
+
+    std::cout << "simd kernel: " << simdLevelName(detectSimdLevel()) << std::endl;
+    for (SimdLevel level : {SimdLevel::SSE2, SimdLevel::AVX2})
+    {
+        std::vector<Outcome> vector(xs.size());
+        classifyBoards(xs, os, vector, WIN_MASKS, FULL_BOARD, level);
+        TEST_ASSERT(scalar == vector);
+    }
+
+    //
+    // X X X X on the 4x4 board
+    std::vector<std::uint16_t> bigX{0x000F, 0x1248};
+    std::vector<std::uint16_t> bigO{0x00F0, 0x0001};
+    std::vector<Outcome> bigOutcomes(2);
+    classifyBoards<Board4x4>(bigX, bigO, bigOutcomes);
+    TEST_ASSERT(Outcome::X_WINS == bigOutcomes[0]);
+    TEST_ASSERT(Outcome::X_WINS == bigOutcomes[1]);
+} // end of test case
+
+///////////////////////////////////////////////////////////////////////////////
+// test_checkGameServer:
+//
+// Verify the server protocol and a round trip over the Unix socket.
+//
+static void test_checkGameServer()
+{
+    GameServer server;
+    TEST_ASSERT_EQUAL_STRING("1 1 1 playing\n", server.handleLine("1 0 0").c_str());
+    TEST_ASSERT_EQUAL_STRING("2 0 0 playing\n", server.handleLine("2 1 1").c_str());
+    TEST_ASSERT_EQUAL_STRING("1 error position occupied\n", server.handleLine("1 1 1").c_str());
+    TEST_ASSERT_EQUAL_STRING("1 error bad position\n", server.handleLine("1 3 0").c_str());
+    TEST_ASSERT_EQUAL_STRING("0 error malformed request\n", server.handleLine("hello").c_str());
+    TEST_ASSERT_EQUAL(2, server.gameCount());
+    TEST_ASSERT_EQUAL_STRING("2 -1 -1 ended\n", server.handleLine("2 end").c_str());
+    TEST_ASSERT_EQUAL(1, server.gameCount());
+
+    //
+    // Play game 1 out, it is a draw and then forgotten
+    server.handleLine("1 0 2");
+    server.handleLine("1 2 1");
+    server.handleLine("1 1 0");
+    TEST_ASSERT_EQUAL_STRING("1 -1 -1 draw\n", server.handleLine("1 1 2").c_str());
+    TEST_ASSERT_EQUAL(0, server.gameCount());
+
+#if defined(__linux__)
+    std::string path = "/tmp/ttd-test-" + std::to_string(getpid()) + ".sock";
+    std::thread serving([&]
+                        { server.run(path); });
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::snprintf(address.sun_path, sizeof(address.sun_path), "%s", path.c_str());
+    int client = socket(AF_UNIX, SOCK_STREAM, 0);
+    bool connected = false;
+    for (int attempt = 0; attempt < 200 && !connected; ++attempt)
+    {
+        connected = connect(client, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == 0;
+        if (!connected)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    }
+    TEST_ASSERT(connected);
+
+    std::string request = "7 0 0\n8 1 1\n7 end\n";
+    TEST_ASSERT_EQUAL(request.size(), send(client, request.data(), request.size(), 0));
+    std::string replies;
+    char buffer[256];
+    while (std::count(replies.begin(), replies.end(), '\n') < 3)
+    {
+        ssize_t received = recv(client, buffer, sizeof(buffer), 0);
+        TEST_ASSERT(received > 0);
+        replies.append(buffer, static_cast<std::size_t>(received));
+    }
+    TEST_ASSERT_EQUAL_STRING("7 1 1 playing\n8 0 0 playing\n7 -1 -1 ended\n", replies.c_str());
+
+    close(client);
+    server.stop();
+    serving.join();
+#endif
+} // end of test case
+
+///////////////////////////////////////////////////////////////////////////////
+// test_checkBatchRunner:
+//
+// Verify batch answers and that a file spanning several chunks comes back
+// in input order.
+//
+static void test_checkBatchRunner()
+{
+    std::string answer;
+    analyzeLine("", answer);
+    analyzeLine("XXX-OO---", answer);
+    analyzeLine("XXXOOO---", answer);
+    analyzeLine("40", answer);
+    analyzeLine("012345678", answer);
+    analyzeLine("44", answer);
+    analyzeLine("XOXXOOOXX\r", answer);
+    TEST_ASSERT_EQUAL_STRING("4 0 playing\n-1 -1000 x-wins\nerror\n2 0 playing\nerror\nerror\n-1 0 draw\n",
+                             answer.c_str());
+
+    const char *lines[] = {"", "4", "40", "XO-------", "4031", "bad line", "01", "XXXOO----"};
+    std::string expected;
+    std::FILE *input = std::tmpfile();
+    std::FILE *output = std::tmpfile();
+    TEST_ASSERT(input != nullptr && output != nullptr);
+    std::size_t written = 0;
+    for (std::size_t line = 0; written < BATCH_CHUNK_BYTES + BATCH_CHUNK_BYTES / 2; ++line)
+    {
+        const char *text = lines[line % (sizeof(lines) / sizeof(lines[0]))];
+        written += std::fprintf(input, "%s\n", text);
+        analyzeLine(text, expected);
+    }
+    std::fputs("4", input);
+    analyzeLine("4", expected);
+    std::rewind(input);
+
+    ThreadPool pool(3);
+    TEST_ASSERT_EQUAL(EXIT_SUCCESS, runBatch(input, output, pool));
+    std::rewind(output);
+    std::string produced(expected.size() + 1, '\0');
+    produced.resize(std::fread(produced.data(), 1, produced.size(), output));
+    TEST_ASSERT(expected == produced);
+    std::fclose(input);
+    std::fclose(output);
+} // end of test case
+
+///////////////////////////////////////////////////////////////////////////////
+// test_checkSearchStats:
+//
+// Verify the search fills its statistics and adds them to the totals, or
+// leaves everything zero when they are compiled out.
+//
+static void test_checkSearchStats()
+{
+    resetSearchTotals();
+    TranspositionTable table(POSITION_COUNT);
+    SearchResult first = alphaBetaSearch(Board{}, table);
+    SearchLimits limits;
+    limits.maxDepth = 4;
+    TranspositionTable bigTable(LARGE_TABLE_ENTRIES);
+    SearchResult second = iterativeDeepeningSearch(Board4x4{}, limits, bigTable);
+    SearchStats totals = searchTotals();
+
+#if TTD_WITH_STATS
+    TEST_ASSERT_EQUAL(1, first.stats.calls);
+    TEST_ASSERT_EQUAL(first.nodes, first.stats.nodes);
+    TEST_ASSERT(first.stats.leaves > 0 && first.stats.leaves < first.nodes);
+    TEST_ASSERT(first.stats.cutoffs > 0);
+    TEST_ASSERT(first.stats.tableHits > 0 && first.stats.tableHits <= first.stats.tableProbes);
+    TEST_ASSERT(first.stats.maxDepth >= 5 && first.stats.maxDepth <= BOARD_CELLS);
+    TEST_ASSERT_EQUAL(4, second.stats.maxDepth);
+
+    TEST_ASSERT_EQUAL(2, totals.calls);
+    TEST_ASSERT_EQUAL(first.nodes + second.nodes, totals.nodes);
+    TEST_ASSERT_EQUAL(first.stats.wallNanos + second.stats.wallNanos, totals.wallNanos);
+    TEST_ASSERT(formatStats(totals).find("calls=2 nodes=") == 0);
+
+    GameServer server;
+    server.handleLine("1 0 0");
+    TEST_ASSERT(server.handleLine("stats").find("stats calls=3 ") == 0);
+#else
+    TEST_ASSERT_EQUAL(0, first.stats.nodes);
+    TEST_ASSERT_EQUAL(0, second.stats.nodes);
+    TEST_ASSERT_EQUAL(0, totals.calls);
+#endif
+} // end of test case
+
+///////////////////////////////////////////////////////////////////////////////
+// test_checkOpeningBook:
+//
+// Verify a written book maps back with the same answers, 3x3 moves coming
+// back in the orientation asked for, and that findBestMove answers from it.
+//
+static void test_checkOpeningBook()
+{
+    std::vector<Board> boards;
+    std::vector<SearchResult> results;
+    for (std::uint32_t key = 0; key < POSITION_COUNT; ++key)
+    {
+        SolvedEntry entry = lookupSolved(key);
+        if (!entry.reachable || entry.move == NO_MOVE)
+        {
+            continue;
+        }
+
+        Board board;
+        for (int cell = 0, digits = key; cell < BOARD_CELLS; ++cell, digits /= 3)
+        {
+            board.x |= digits % 3 == 1 ? cellMask(cell) : 0;
+            board.o |= digits % 3 == 2 ? cellMask(cell) : 0;
+        }
+        boards.push_back(board);
+        SearchResult result;
+        result.move = entry.move;
+        result.score = entry.score;
+        result.depth = std::popcount(legalMoveMask(board));
+        results.push_back(result);
+    }
+
+    std::string path = "/tmp/ttd-test-" + std::to_string(getpid()) + ".book";
+    TEST_ASSERT(writeOpeningBook<Board>(path, boards, results));
+    OpeningBook book;
+    TEST_ASSERT(!book.open(path, 4, 4, 4));
+    TEST_ASSERT(book.open(path, 3, 3, 3));
+    TEST_ASSERT(book.size() < boards.size());
+    for (std::size_t index = 0; index < boards.size(); ++index)
+    {
+        SearchResult answer;
+        TEST_ASSERT(probeBook(book, boards[index], answer));
+        TEST_ASSERT_EQUAL(results[index].score, answer.score);
+        TEST_ASSERT_EQUAL(results[index].depth, answer.depth);
+        TEST_ASSERT(legalMoveMask(boards[index]) & cellMask(answer.move));
+        Board next = playMove(boards[index], answer.move, xToMove(boards[index]));
+        TEST_ASSERT_EQUAL(answer.score, scoreBeforeMove(lookupSolved(next).score));
+    }
+    book.close();
+
+    //
+    // A 4x4 book loaded for the process answers findBestMove without a search
+    std::vector<Board4x4> bigBoards{Board4x4{}, playMove(Board4x4{}, 5, true)};
+    std::vector<SearchResult> bigResults{SearchResult{7, 11, 3, 0}, SearchResult{10, -12, 3, 0}};
+    TEST_ASSERT(writeOpeningBook<Board4x4>(path, bigBoards, bigResults));
+    TEST_ASSERT(loadOpeningBook(path));
+    TEST_ASSERT(openingBook<Board4x4>().isOpen());
+    SearchResult fromBook = findBestMove(bigBoards[1], SearchLimits{});
+    TEST_ASSERT_EQUAL(10, fromBook.move);
+    TEST_ASSERT_EQUAL(-12, fromBook.score);
+    TEST_ASSERT_EQUAL(0, fromBook.nodes);
+    openingBook<Board4x4>().close();
+
+    //
+    // A cut short file is refused
+    TEST_ASSERT_EQUAL(0, truncate(path.c_str(), sizeof(BookHeader) + 5));
+    TEST_ASSERT(!book.open(path, 4, 4, 4));
+    std::remove(path.c_str());
+} // end of test case
+
+///////////////////////////////////////////////////////////////////////////////
+// test_checkPosition:
+//
+// Verify make and unmake keep a position equal to one built from scratch,
+// and that the search honours an explicit side to move.
+//
+template <typename B>
+static void checkPositionPlayouts()
+{
+    std::uint32_t seed = 12345;
+    for (int game = 0; game < 50; ++game)
+    {
+        Position<B> position;
+        std::vector<int> played;
+        while (!position.gameOver())
+        {
+            typename B::Mask legalMoves = position.legalMoves();
+            seed = seed * 1664525u + 1013904223u;
+            int skip = static_cast<int>((seed >> 16) % std::popcount(legalMoves));
+            for (; skip > 0; --skip)
+            {
+                legalMoves &= legalMoves - 1;
+            }
+            int cell = std::countr_zero(legalMoves);
+            position.make(cell);
+            played.push_back(cell);
+
+            Position<B> fresh(position.board(), position.xMoves());
+            TEST_ASSERT(fresh.hash() == position.hash());
+            TEST_ASSERT_EQUAL(fresh.emptyCount(), position.emptyCount());
+            TEST_ASSERT_EQUAL(fresh.state(), position.state());
+            TEST_ASSERT_EQUAL(boardState(position.board(), position.xMoves()), position.state());
+            TEST_ASSERT_EQUAL(fresh.gameOver(), position.gameOver());
+            for (int line = 0; line < B::LINE_COUNT; ++line)
+            {
+                TEST_ASSERT_EQUAL(fresh.lineCount(true, line), position.lineCount(true, line));
+                TEST_ASSERT_EQUAL(fresh.lineCount(false, line), position.lineCount(false, line));
+            }
+        }
+
+        for (auto cell = played.rbegin(); cell != played.rend(); ++cell)
+        {
+            position.unmake(*cell);
+        }
+        TEST_ASSERT(position.board().x == 0 && position.board().o == 0);
+        TEST_ASSERT(position.xMoves());
+        TEST_ASSERT(position.hash() == 0);
+    }
+}
+
+static void test_checkPosition()
+{
+    checkPositionPlayouts<Board>();
+    checkPositionPlayouts<Board4x4>();
+    checkPositionPlayouts<Board7x7>();
+
+    //
+    // X gets the center as a handicap and still moves first, the mark
+    // count alone would hand the move to O
+    Board handicap = playMove(Board{}, 4, true);
+    TranspositionTable table(2 * POSITION_COUNT);
+    SearchResult xFirst = alphaBetaSearch(Position<Board>(handicap, true), table);
+    TEST_ASSERT(xFirst.score >= HEURISTIC_LIMIT);
+    TEST_ASSERT(legalMoveMask(handicap) & cellMask(xFirst.move));
+    TEST_ASSERT_EQUAL(static_cast<int>(State::WIN) - xFirst.score, xFirst.line.length);
+
+    SearchResult oFirst = alphaBetaSearch(Position<Board>(handicap, false), table);
+    TranspositionTable freshTable(2 * POSITION_COUNT);
+    TEST_ASSERT_EQUAL(alphaBetaSearch(handicap, freshTable).score, oFirst.score);
+    TEST_ASSERT_EQUAL(static_cast<int>(State::DRAW), oFirst.score);
+} // end of test case
+
+///////////////////////////////////////////////////////////////////////////////
+// test_checkSearchAllocations:
+//
+// Verify a search allocates nothing once the shared tables and the pool
+// exist, serial or on the pool, from the solved table or searched.
+//
+static void test_checkSearchAllocations()
+{
+    SearchLimits depthFive;
+    depthFive.maxDepth = 5;
+    ThreadPool pool(3);
+    TranspositionTable table(2 * POSITION_COUNT);
+    Grid midGrid = {{{PLAYER_MARKER, EMPTY_SPACE, AI_MARKER},
+                     {EMPTY_SPACE, PLAYER_MARKER, EMPTY_SPACE},
+                     {EMPTY_SPACE, EMPTY_SPACE, AI_MARKER}}};
+    Board4x4 board = playMove(playMove(Board4x4{}, 5, true), 10, false);
+    findBestMove(midGrid);
+    findBestMove(board, depthFive);
+    findBestMove(board, depthFive, pool);
+    alphaBetaSearch(Board{}, table);
+
+    std::uint64_t before = allocationCount.load();
+    findBestMove(Grid{});
+    findBestMove(midGrid);
+    TEST_ASSERT_EQUAL_UINT64(before, allocationCount.load());
+
+    for (int round = 0; round < 3; ++round)
+    {
+        sharedSearchTable<Board4x4>().clear();
+        findBestMove(board, depthFive);
+        TEST_ASSERT_EQUAL_UINT64(before, allocationCount.load());
+
+        sharedSearchTable<Board4x4>().clear();
+        SearchResult result = findBestMove(board, depthFive, pool);
+        TEST_ASSERT(legalMoveMask(board) & Board4x4::cellMask(result.move));
+        TEST_ASSERT_EQUAL_UINT64(before, allocationCount.load());
+    }
+
+    table.clear();
+    alphaBetaSearch(Board{}, table);
+    TEST_ASSERT_EQUAL_UINT64(before, allocationCount.load());
+} // end of test case
+
+///////////////////////////////////////////////////////////////////////////////
+// test_checkMateDistance:
+//
+// Verify wins are taken as soon as they are on the board and the search
+// hands back the whole line it expects, not just the first move.
+//
+static int checkQuickWinsFrom(Board board, int &immediateWins)
+{
+    bool forX = xToMove(board);
+    if (boardFull(board) || boardState(board, forX) != static_cast<int>(State::DRAW))
+    {
+        return 0;
+    }
+
+    int mismatches = 0;
+    bool winNow = false;
+    for (Mask moves = legalMoveMask(board); moves != 0; moves &= moves - 1)
+    {
+        Board next = playMove(board, std::countr_zero(moves), forX);
+        winNow = winNow || boardState(next, forX) == static_cast<int>(State::WIN);
+        mismatches += checkQuickWinsFrom(next, immediateWins);
+    }
+
+    if (winNow)
+    {
+        ++immediateWins;
+        SolvedEntry entry = lookupSolved(board);
+        mismatches += entry.score == static_cast<int>(State::WIN) - 1 ? 0 : 1;
+        mismatches += boardState(playMove(board, entry.move, forX), forX) == static_cast<int>(State::WIN) ? 0 : 1;
+    }
+    return mismatches;
+}
+
+template <typename B>
+static void playLine(B &board, const MoveLine &line)
+{
+    for (int index = 0; index < line.length; ++index)
+    {
+        TEST_ASSERT(legalMoveMask(board) & B::cellMask(line.moves[index]));
+        board = playMove(board, line.moves[index], xToMove(board));
+    }
+}
+
+static void test_checkMateDistance()
+{
+    int immediateWins = 0;
+    TEST_ASSERT_EQUAL(0, checkQuickWinsFrom(Board{}, immediateWins));
+    TEST_ASSERT(immediateWins > 0);
+
+    //
+    // X X -
+    // O - -
+    // - - O
+    // X wins at (0, 2) now, the center forks and wins a move later
+    Board board{static_cast<Mask>(cellMask(0) | cellMask(1)), static_cast<Mask>(cellMask(3) | cellMask(8))};
+    TranspositionTable table(2 * POSITION_COUNT);
+    SearchResult quick = alphaBetaSearch(board, table);
+    TEST_ASSERT_EQUAL(static_cast<int>(State::WIN) - 1, quick.score);
+    TEST_ASSERT_EQUAL(2, quick.move);
+    TEST_ASSERT_EQUAL(1, quick.line.length);
+    TEST_ASSERT_EQUAL(quick.score, minimaxSearch(board).score);
+
+    //
+    // The whole game drawn, both sides playing it to the last cell
+    table.clear();
+    SearchResult game = alphaBetaSearch(Board{}, table);
+    TEST_ASSERT_EQUAL(BOARD_CELLS, game.line.length);
+    TEST_ASSERT_EQUAL(game.move, game.line.moves[0]);
+    Board end;
+    playLine(end, game.line);
+    TEST_ASSERT(boardFull(end));
+    TEST_ASSERT_EQUAL(static_cast<int>(State::DRAW), boardState(end, true));
+    Board along;
+    for (int index = 0; index < game.line.length; ++index)
+    {
+        along = playMove(along, game.line.moves[index], xToMove(along));
+        TEST_ASSERT_EQUAL(static_cast<int>(State::DRAW), lookupSolved(along).score);
+    }
+
+    //
+    // X O X O
+    // - - - -
+    // O X O X
+    // - - - -
+    // Decided lines run to the end of the game, the rest to the depth
+    Board4x4 endgame;
+    endgame.x = Board4x4::cellMask(0) | Board4x4::cellMask(2) | Board4x4::cellMask(9) | Board4x4::cellMask(11);
+    endgame.o = Board4x4::cellMask(1) | Board4x4::cellMask(3) | Board4x4::cellMask(8) | Board4x4::cellMask(10);
+    TranspositionTable largeTable(1 << 16);
+    ThreadPool pool(3);
+    SearchResult solved = parallelSearch(endgame, SearchLimits{}, largeTable, pool);
+    TEST_ASSERT_EQUAL(solved.move, solved.line.moves[0]);
+    Board4x4 last = endgame;
+    playLine(last, solved.line);
+    TEST_ASSERT(boardFull(last) || boardState(last, true) != static_cast<int>(State::DRAW));
+    if (isDecided(solved.score))
+    {
+        TEST_ASSERT_EQUAL(static_cast<int>(State::WIN) - std::abs(solved.score), solved.line.length);
+    }
+
+    SearchLimits depthFour;
+    depthFour.maxDepth = 4;
+    largeTable.clear();
+    SearchResult shallow = iterativeDeepeningSearch(Board4x4{}, depthFour, largeTable);
+    TEST_ASSERT_EQUAL(4, shallow.line.length);
+    Board4x4 opening;
+    playLine(opening, shallow.line);
+} // end of test case
+
+///////////////////////////////////////////////////////////////////////////////
+// test_checkMonteCarloSearch:
+//
+// Verify the tree search finds forced moves, keeps to its playout and
+// time budgets on any number of threads and never allocates.
+//
+static void test_checkMonteCarloSearch()
+{
+    MctsLimits limits;
+    limits.maxPlayouts = 20000;
+    MctsTree tree(1 << 16);
+
+    //
+    // X X -
+    // O - -
+    // - - O
+    // X wins at (0, 2)
+    Board board{static_cast<Mask>(cellMask(0) | cellMask(1)), static_cast<Mask>(cellMask(3) | cellMask(8))};
+    MctsResult result = monteCarloSearch(Position<Board>(board), limits, tree, nullptr);
+    TEST_ASSERT_EQUAL(2, result.move);
+    TEST_ASSERT(result.value > 0.9);
+    TEST_ASSERT_EQUAL_UINT64(limits.maxPlayouts, result.playouts);
+    TEST_ASSERT(result.nodes > 1 && result.nodes <= tree.capacity());
+
+    //
+    // X - -
+    // O O -
+    // - - X
+    // X has to block at (1, 2)
+    board = Board{static_cast<Mask>(cellMask(0) | cellMask(8)), static_cast<Mask>(cellMask(3) | cellMask(4))};
+    ThreadPool pool(3);
+    result = monteCarloSearch(Position<Board>(board), limits, tree, &pool);
+    TEST_ASSERT_EQUAL(5, result.move);
+    TEST_ASSERT_EQUAL_UINT64(limits.maxPlayouts, result.playouts);
+
+    //
+    // A pool too small to grow the tree still gives a legal move, a
+    // finished game none
+    MctsTree bare(1);
+    result = monteCarloSearch(Position<Board4x4>(), limits, bare, &pool);
+    TEST_ASSERT_EQUAL(1, result.nodes);
+    TEST_ASSERT(legalMoveMask(Board4x4{}) & Board4x4::cellMask(result.move));
+    result = monteCarloSearch(Position<Board>(Board{0x007, 0x018}), limits, tree, &pool);
+    TEST_ASSERT_EQUAL(NO_MOVE, result.move);
+    TEST_ASSERT_EQUAL_UINT64(0, result.playouts);
+
+    //
+    // Bounded by time alone on the big board, allocating nothing
+    Board7x7 big = playMove(Board7x7{}, Board7x7::cellIndex(3, 3), true);
+    MctsLimits timed;
+    timed.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(50);
+    findBestMove(big, timed, pool);
+    timed.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(100);
+    std::uint64_t before = allocationCount.load();
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    result = findBestMove(big, timed, pool);
+    TEST_ASSERT_EQUAL_UINT64(before, allocationCount.load());
+    TEST_ASSERT(std::chrono::steady_clock::now() - start < std::chrono::seconds(2));
+    TEST_ASSERT(legalMoveMask(big) & Board7x7::cellMask(result.move));
+    TEST_ASSERT(result.playouts > 0 && result.playoutsPerSecond() > 0.0);
+    std::cout << "7x7 tree search: " << result.playouts << " playouts, "
+              << static_cast<std::uint64_t>(result.playoutsPerSecond()) << " per second" << std::endl;
+} // end of test case
+
+///////////////////////////////////////////////////////////////////////////////
+// test_checkPerft:
+//
+// Verify the enumeration reproduces the known 3x3 game tree, walked or
+// merged, and both ways agree on a bigger board.
+//
+static void test_checkPerft()
+{
+    const std::uint64_t NODES_BY_PLY[] = {1, 9, 72, 504, 3024, 15120, 54720, 148176, 200448, 127872};
+    ThreadPool pool(3);
+    for (bool merge : {false, true})
+    {
+        std::vector<PerftLevel> levels = perft(Board{}, 9, pool, merge);
+        TEST_ASSERT_EQUAL(10, levels.size());
+        PerftLevel total;
+        for (std::size_t ply = 0; ply < levels.size(); ++ply)
+        {
+            TEST_ASSERT_EQUAL_UINT64(NODES_BY_PLY[ply], levels[ply].nodes);
+            total.xWins += levels[ply].xWins;
+            total.oWins += levels[ply].oWins;
+            total.draws += levels[ply].draws;
+            total.positions += levels[ply].positions;
+        }
+        TEST_ASSERT_EQUAL_UINT64(131184, total.xWins);
+        TEST_ASSERT_EQUAL_UINT64(77904, total.oWins);
+        TEST_ASSERT_EQUAL_UINT64(46080, total.draws);
+        TEST_ASSERT_EQUAL_UINT64(merge ? solvedReachableCount() : 0, total.positions);
+        TEST_ASSERT_EQUAL_UINT64(1440, levels[5].xWins);
+    }
+
+    //
+    // A finished board is a single node and a single game
+    std::vector<PerftLevel> over = perft(Board{0x007, 0x018}, 3, pool, false);
+    TEST_ASSERT_EQUAL_UINT64(1, over[0].nodes + over[1].nodes + over[2].nodes + over[3].nodes);
+    TEST_ASSERT_EQUAL_UINT64(1, over[0].xWins);
+
+    std::vector<PerftLevel> walked = perft(Board4x4{}, 5, pool, false);
+    std::vector<PerftLevel> merged = perft(Board4x4{}, 5, pool, true);
+    for (std::size_t ply = 0; ply < walked.size(); ++ply)
+    {
+        TEST_ASSERT_EQUAL_UINT64(walked[ply].nodes, merged[ply].nodes);
+        TEST_ASSERT(merged[ply].positions <= merged[ply].nodes);
+    }
+    TEST_ASSERT_EQUAL_UINT64(16 * 15 * 14 * 13 * 12, walked[5].nodes);
+} // end of test case
+
+///////////////////////////////////////////////////////////////////////////////
+// test_checkTablebase:
+//
+// Verify the ranking numbers every 3x3 position once, a built 3x3
+// tablebase agrees with the solved table and its moves keep the value,
+// and a 4x4 endgame tablebase agrees with the search and answers
+// findBestMove once loaded.
+//
+static void test_checkTablebase()
+{
+    std::uint64_t count = LAYER_STARTS<Board>[BOARD_CELLS + 1];
+    std::vector<bool> ranked(count);
+    for (std::uint32_t key = 0; key < POSITION_COUNT; ++key)
+    {
+        Board board;
+        for (int cell = 0, digits = key; cell < BOARD_CELLS; ++cell, digits /= 3)
+        {
+            board.x |= digits % 3 == 1 ? cellMask(cell) : 0;
+            board.o |= digits % 3 == 2 ? cellMask(cell) : 0;
+        }
+        if (!hasMoveParity(board))
+        {
+            continue;
+        }
+
+        std::uint64_t index = tablebaseIndex(board, 0);
+        TEST_ASSERT(index < count);
+        TEST_ASSERT(!ranked[index]);
+        ranked[index] = true;
+    }
+    TEST_ASSERT(std::all_of(ranked.begin(), ranked.end(), [](bool seen)
+                            { return seen; }));
+
+    std::string path = "/tmp/ttd-test-" + std::to_string(getpid()) + ".tb";
+    ThreadPool pool(3);
+    TEST_ASSERT(buildTablebase<Board>(path, 0, pool));
+    Tablebase tablebase;
+    TEST_ASSERT(!tablebase.open(path, 4, 4, 4));
+    TEST_ASSERT(tablebase.open(path, 3, 3, 3));
+    TEST_ASSERT_EQUAL_UINT64(count, tablebase.size());
+    for (std::uint32_t key = 0; key < POSITION_COUNT; ++key)
+    {
+        SolvedEntry entry = lookupSolved(key);
+        if (!entry.reachable)
+        {
+            continue;
+        }
+
+        Board board;
+        for (int cell = 0, digits = key; cell < BOARD_CELLS; ++cell, digits /= 3)
+        {
+            board.x |= digits % 3 == 1 ? cellMask(cell) : 0;
+            board.o |= digits % 3 == 2 ? cellMask(cell) : 0;
+        }
+        SearchResult answer;
+        TEST_ASSERT(probeTablebase(tablebase, board, answer));
+        TEST_ASSERT_EQUAL((entry.score > 0) - (entry.score < 0), (answer.score > 0) - (answer.score < 0));
+        if (entry.move != NO_MOVE)
+        {
+            TEST_ASSERT(legalMoveMask(board) & cellMask(answer.move));
+            int after = scoreBeforeMove(lookupSolved(playMove(board, answer.move, xToMove(board))).score);
+            TEST_ASSERT_EQUAL((entry.score > 0) - (entry.score < 0), (after > 0) - (after < 0));
+        }
+    }
+    tablebase.close();
+
+    //
+    // Late 4x4 positions, from a fixed spread of move orders
+    TEST_ASSERT(buildTablebase<Board4x4>(path, 11, pool));
+    TEST_ASSERT(loadTablebase(path));
+    const Tablebase &endgame = endgameTablebase<Board4x4>();
+    TEST_ASSERT(endgame.isOpen());
+    TEST_ASSERT_EQUAL(11, endgame.minMarks());
+    TEST_ASSERT(!endgame.covers(Board4x4{}));
+    TranspositionTable table(1 << 16);
+    int compared = 0;
+    for (int start = 0; start < 16; ++start)
+    {
+        Board4x4 board;
+        for (int ply = 0; ply < 12 && boardState(board, xToMove(board)) == static_cast<int>(State::DRAW); ++ply)
+        {
+            board = playMove(board, (start + ply * 5) % 16, xToMove(board));
+        }
+        if (!endgame.covers(board) || boardState(board, xToMove(board)) != static_cast<int>(State::DRAW))
+        {
+            continue;
+        }
+
+        table.clear();
+        SearchResult searched = alphaBetaSearch(board, table);
+        SearchResult probed = findBestMove(board, SearchLimits{});
+        TEST_ASSERT_EQUAL(0, probed.nodes);
+        TEST_ASSERT_EQUAL((searched.score > 0) - (searched.score < 0), (probed.score > 0) - (probed.score < 0));
+        table.clear();
+        SearchResult reply = alphaBetaSearch(playMove(board, probed.move, xToMove(board)), table);
+        TEST_ASSERT_EQUAL((searched.score > 0) - (searched.score < 0), (reply.score < 0) - (reply.score > 0));
+        ++compared;
+    }
+    TEST_ASSERT(compared > 0);
+    endgameTablebase<Board4x4>().close();
+
+    //
+    // A cut short file is refused
+    TEST_ASSERT_EQUAL(0, truncate(path.c_str(), sizeof(TablebaseHeader) + 8));
+    TEST_ASSERT(!tablebase.open(path, 4, 4, 4));
+    std::remove(path.c_str());
+} // end of test case
+
+///////////////////////////////////////////////////////////////////////////////
+// test_checkPondering:
+//
+// Verify a background search can be cancelled and still answers with a
+// legal move, and that a move answered after pondering agrees with a
+// cold search at a fraction of its nodes.
+//
+static void test_checkPondering()
+{
+    SearchTask task = startSearch(Board5x5{}, SearchLimits{});
+    TEST_ASSERT(task.running());
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    task.cancel();
+    SearchResult cancelled = task.wait();
+    TEST_ASSERT(!task.running());
+    TEST_ASSERT(legalMoveMask(Board5x5{}) & Board5x5::cellMask(cancelled.move));
+    TEST_ASSERT(cancelled.nodes > 0);
+
+    //
+    // A budget the task was given still applies
+    SearchLimits limits;
+    limits.maxDepth = 2;
+    task = startSearch(Board4x4{}, limits);
+    TEST_ASSERT_EQUAL(2, task.wait().depth);
+
+    //
+    // A 4x4 endgame with 9 cells left, pondered to the end
+    Board4x4 board;
+    for (int ply = 0; ply < 7; ++ply)
+    {
+        board = playMove(board, ply * 5 % 16, xToMove(board));
+    }
+    Board4x4 replied = playMove(board, std::countr_zero(legalMoveMask(board)), xToMove(board));
+    Engine<Board4x4> coldEngine(1 << 20);
+    coldEngine.setBoard(replied);
+    SearchResult cold = coldEngine.think(SearchLimits{});
+    Engine<Board4x4> engine(1 << 20);
+    Ponderer<Board4x4> ponderer(engine);
+    ponderer.ponder(board);
+    while (ponderer.pondering())
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    SearchResult warm = ponderer.respond(replied, SearchLimits{});
+    TEST_ASSERT_EQUAL(cold.score, warm.score);
+    TEST_ASSERT(legalMoveMask(replied) & Board4x4::cellMask(warm.move));
+    TEST_ASSERT(warm.nodes < cold.nodes);
+
+    //
+    // A finished game is not pondered, and stopping twice is harmless
+    ponderer.ponder(Board4x4{0x000F, 0x0070});
+    TEST_ASSERT(!ponderer.pondering());
+    ponderer.stop();
+    ponderer.stop();
+
+    //
+    // 3x3 is looked up, never pondered or searched
+    Engine<Board> small(TABLE_SLOT_BYTES);
+    Ponderer<Board> lookup(small);
+    lookup.ponder(playMove(Board{}, 4, true));
+    TEST_ASSERT(!lookup.pondering());
+    SearchResult solved = lookup.respond(playMove(playMove(Board{}, 4, true), 0, false), SearchLimits{});
+    TEST_ASSERT_EQUAL(0, solved.nodes);
+    TEST_ASSERT_EQUAL(lookupSolved(playMove(playMove(Board{}, 4, true), 0, false)).move, solved.move);
+} // end of test case
+
+///////////////////////////////////////////////////////////////////////////////
+// test_checkEngine:
+//
+// Verify the table keeps deep results of the current search and gives way
+// to newer searches, and that an engine stays within its memory, follows
+// the game and searches less for a move it already looked into.
+//
+static void test_checkEngine()
+{
+    TranspositionTable table(1);
+    TableEntry entry;
+    table.store(1, 0, 2, Bound::EXACT, 5);
+    table.store(2, 0, 3, Bound::EXACT, 3);
+    TEST_ASSERT(table.probe(1, entry));
+    TEST_ASSERT(!table.probe(2, entry));
+    table.store(1, 0, 4, Bound::EXACT, 1);
+    TEST_ASSERT(table.probe(1, entry));
+    TEST_ASSERT_EQUAL(4, entry.bestMove);
+    table.newSearch();
+    TEST_ASSERT(table.probe(1, entry));
+    table.store(2, 0, 3, Bound::EXACT, 0);
+    TEST_ASSERT(table.probe(2, entry));
+    TEST_ASSERT(!table.probe(1, entry));
+
+    //
+    // A deep entry 256 searches old still gives way
+    table.store(1, 0, 2, Bound::EXACT, 9);
+    for (int search = 0; search < 256; ++search)
+    {
+        table.newSearch();
+    }
+    table.store(2, 0, 3, Bound::EXACT, 0);
+    TEST_ASSERT(table.probe(2, entry));
+
+    Engine<Board4x4> engine(1 << 20);
+    TEST_ASSERT_EQUAL(1 << 20, engine.table().memoryBytes());
+    TEST_ASSERT_EQUAL(std::bit_ceil(2u * POSITION_COUNT) * TABLE_SLOT_BYTES, Engine<Board>(1 << 30).table().memoryBytes());
+    TEST_ASSERT_EQUAL(TABLE_SLOT_BYTES, Engine<Board7x7>(0).table().memoryBytes());
+
+    //
+    // Boards adding moves to the game are followed, any other starts over
+    Board4x4 board = playMove(playMove(Board4x4{}, 5, true), 6, false);
+    engine.setBoard(board);
+    board = playMove(playMove(board, 9, true), 10, false);
+    engine.setBoard(board);
+    TEST_ASSERT_EQUAL_UINT64(Position<Board4x4>(board).hash(), engine.position().hash());
+    engine.setBoard(Board4x4{Board4x4::cellMask(0), Board4x4::cellMask(1)});
+    TEST_ASSERT_EQUAL(14, engine.position().emptyCount());
+
+    //
+    // The engine's second move comes mostly from what its first one proved
+    SearchLimits limits;
+    limits.maxDepth = 7;
+    engine.clear();
+    SearchResult first = engine.think(limits);
+    TEST_ASSERT(first.line.length >= 2);
+    engine.play(first.move);
+    engine.play(first.line.moves[1]);
+    SearchResult second = engine.think(limits);
+    Engine<Board4x4> fresh(1 << 20);
+    fresh.setBoard(engine.position().board());
+    SearchResult cold = fresh.think(limits);
+    TEST_ASSERT(legalMoveMask(engine.position().board()) & Board4x4::cellMask(second.move));
+    TEST_ASSERT(second.nodes < cold.nodes);
+    std::cout << "second move: " << second.nodes << " nodes kept, " << cold.nodes << " cold" << std::endl;
+} // end of test case
+
 //
 //  here main is used as the test runner
 //
@@ -622,6 +1985,28 @@ int main(void)
     RUN_TEST(test_checkGetBoardState);
     RUN_TEST(test_checkFindBestMove);
     RUN_TEST(test_checkGameIsDone);
+    RUN_TEST(test_checkBitboardAdapters);
+    RUN_TEST(test_checkTranspositionTable);
+    RUN_TEST(test_checkSymmetry);
+    RUN_TEST(test_checkAlphaBetaSearch);
+    RUN_TEST(test_checkSolvedTable);
+    RUN_TEST(test_checkGeneralizedBoards);
+    RUN_TEST(test_checkIterativeDeepening);
+    RUN_TEST(test_checkParallelSearch);
+    RUN_TEST(test_checkFindBestMoves);
+    RUN_TEST(test_checkSimdKernel);
+    RUN_TEST(test_checkGameServer);
+    RUN_TEST(test_checkBatchRunner);
+    RUN_TEST(test_checkSearchStats);
+    RUN_TEST(test_checkOpeningBook);
+    RUN_TEST(test_checkPosition);
+    RUN_TEST(test_checkSearchAllocations);
+    RUN_TEST(test_checkMateDistance);
+    RUN_TEST(test_checkMonteCarloSearch);
+    RUN_TEST(test_checkPerft);
+    RUN_TEST(test_checkTablebase);
+    RUN_TEST(test_checkPondering);
+    RUN_TEST(test_checkEngine);
 
     return UNITY_END();
 } // end of function main
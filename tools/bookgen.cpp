@@ -0,0 +1,115 @@
+//
+// file: bookgen.cpp
+// author: Michael Brockus
+// gmail: <michaelbrockus@gmail.com>
+//
+// USE CASE:
+//
+// Generate an opening book for the engine. Every position reachable from
+// the empty board within the given number of plies, and not already
+// decided, is searched and written with its best move and score:
+//
+//     bookgen <3x3|4x4|5x5|7x7> <plies> <output file> [search depth]
+//
+// A search depth of 0, the default, searches to the end of the game,
+// which is what the 3x3 board wants with 9 plies to cover every position.
+//
+#include "book.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+//
+// Undecided positions within plies moves of the empty board, one per key
+//
+template <typename B>
+static std::vector<B> collectPositions(int plies)
+{
+    std::vector<B> positions;
+    std::vector<B> frontier{B{}};
+    std::unordered_set<std::uint64_t> seen;
+    for (int ply = 0; ply <= plies && !frontier.empty(); ++ply)
+    {
+        std::vector<B> next;
+        for (B board : frontier)
+        {
+            int symmetry;
+            if (boardState(board, xToMove(board)) != static_cast<int>(State::DRAW) || boardFull(board) ||
+                !seen.insert(bookKey(board, symmetry)).second)
+            {
+                continue;
+            } // end if
+
+            positions.push_back(board);
+            typename B::Mask legalMoves = legalMoveMask(board);
+            for (int cell = 0; cell < B::CELLS; ++cell)
+            {
+                if (legalMoves & B::cellMask(cell))
+                {
+                    next.push_back(playMove(board, cell, xToMove(board)));
+                } // end if
+
+            } // end for
+        } // end for
+        frontier.swap(next);
+    } // end for
+
+    return positions;
+} // end of function collectPositions
+
+template <typename B>
+static int generate(int plies, int depth, const std::string &path)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::vector<B> positions = collectPositions<B>(plies);
+    std::vector<SearchResult> results(positions.size());
+    SearchLimits limits;
+    limits.maxDepth = depth;
+    ThreadPool pool;
+    findBestMoves<B>(positions, results, limits, pool);
+    if (!writeOpeningBook<B>(path, positions, results))
+    {
+        std::perror(path.c_str());
+        return EXIT_FAILURE;
+    } // end if
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("%zu positions, %zu bytes, %.2f s\n", positions.size(),
+                sizeof(BookHeader) + positions.size() * BOOK_ENTRY_BYTES, seconds);
+    return EXIT_SUCCESS;
+} // end of function generate
+
+int main(int argc, char **argv)
+{
+    if (argc < 4)
+    {
+        std::fprintf(stderr, "usage: %s <3x3|4x4|5x5|7x7> <plies> <output file> [search depth]\n", argv[0]);
+        return EXIT_FAILURE;
+    } // end if
+
+    std::string size = argv[1];
+    int plies = std::atoi(argv[2]);
+    int depth = argc > 4 ? std::atoi(argv[4]) : 0;
+    if (size == "3x3")
+    {
+        return generate<Board>(plies, depth, argv[3]);
+    } // end if
+    else if (size == "4x4")
+    {
+        return generate<Board4x4>(plies, depth, argv[3]);
+    } // end else if
+    else if (size == "5x5")
+    {
+        return generate<Board5x5>(plies, depth, argv[3]);
+    } // end else if
+    else if (size == "7x7")
+    {
+        return generate<Board7x7>(plies, depth, argv[3]);
+    } // end else if
+
+    std::fprintf(stderr, "unknown board size %s\n", argv[1]);
+    return EXIT_FAILURE;
+} // end of function main
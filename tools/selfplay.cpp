@@ -0,0 +1,407 @@
+//
+// file: selfplay.cpp
+// author: Michael Brockus
+// gmail: <michaelbrockus@gmail.com>
+//
+// USE CASE:
+//
+// Play the engines against each other, or against a random player, to
+// check what a change does to the strength of play:
+//
+//     selfplay <3x3|4x4|5x5|7x7> <games> <player A> <player B> [options]
+//
+// where a player is engine (alpha-beta, the solved table on 3x3), mcts or
+// random. A plays X in even games and O in odd ones. Options:
+//
+//     --seed <n>       base of the per-game seeds, default 1
+//     --opening <n>    plies played at random before the players take over
+//     --depth <n>      engine search depth on boards above 3x3, default 4
+//     --playouts <n>   mcts playouts per move, default 1000
+//     --threads <n>    worker threads, default one per core
+//     --records <file> write every game, one per line, in game order
+//
+// Every game is seeded from its own number alone and every player starts
+// it from a clean state, so a run plays the same games whatever the
+// thread count. A record line is
+//
+//     <game> <x player> <o player> <x-wins|o-wins|draw> <cell>,<cell>,...
+//
+#include "engine.hpp"
+#include "mcts.hpp"
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+//
+// Games shared out per round, records of a round are written before the
+// next one starts
+const std::uint64_t ROUND_GAMES = 1 << 16;
+
+enum class Player
+{
+    ENGINE,
+    MCTS,
+    RANDOM
+};
+
+const char *const PLAYER_NAMES[] = {"engine", "mcts", "random"};
+
+struct Options
+{
+    std::uint64_t games = 0;
+    std::array<Player, 2> players{};
+    std::uint64_t seed = 1;
+    int opening = 0;
+    int depth = 4;
+    std::uint64_t playouts = 1000;
+    unsigned threads = 0;
+    const char *records = nullptr;
+};
+
+//
+// Wins, draws and losses of player A, by the side A played
+//
+struct Tally
+{
+    std::array<std::array<std::uint64_t, 3>, 2> results{};
+    std::uint64_t plies = 0;
+
+    void add(const Tally &other)
+    {
+        for (int side = 0; side < 2; ++side)
+        {
+            for (int result = 0; result < 3; ++result)
+            {
+                results[side][result] += other.results[side][result];
+            } // end for
+
+        } // end for
+        plies += other.plies;
+    } // end of function add
+};
+
+const int A_WINS = 0;
+const int DRAWN = 1;
+const int A_LOSES = 2;
+
+//
+// splitmix64, turns a game number into a well mixed seed
+//
+static std::uint64_t mixSeed(std::uint64_t value)
+{
+    value += 0x9E3779B97F4A7C15ull;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+    return value ^ (value >> 31);
+} // end of function mixSeed
+
+template <typename B>
+static int randomMove(typename B::Mask legalMoves, std::uint64_t &random)
+{
+    random = mixSeed(random);
+    int skip = static_cast<int>(random % static_cast<std::uint64_t>(std::popcount(legalMoves)));
+    for (; skip > 0; --skip)
+    {
+        legalMoves &= legalMoves - 1;
+    } // end for
+    return std::countr_zero(legalMoves);
+} // end of function randomMove
+
+//
+// What one worker needs to play its games, made once per worker
+//
+template <typename B>
+struct Players
+{
+    const Options &options;
+    Engine<B> engine;
+    MctsTree tree;
+
+    explicit Players(const Options &options)
+        : options(options), engine(std::is_same_v<B, Board> ? TABLE_SLOT_BYTES : (1 << 14) * TABLE_SLOT_BYTES),
+          tree(options.players[0] == Player::MCTS || options.players[1] == Player::MCTS
+                   ? std::min<std::size_t>(MCTS_TREE_NODES, options.playouts * B::CELLS + 1)
+                   : 1)
+    {
+    } // end of constructor
+
+    int move(Player player, const Position<B> &position, std::uint64_t &random)
+    {
+        if (player == Player::RANDOM)
+        {
+            return randomMove<B>(position.legalMoves(), random);
+        } // end if
+        else if (player == Player::MCTS)
+        {
+            MctsLimits limits;
+            limits.maxPlayouts = options.playouts;
+            return monteCarloSearch(position, limits, tree, nullptr).move;
+        } // end else if
+
+        SearchLimits limits;
+        limits.maxDepth = options.depth;
+        engine.setBoard(position.board());
+        return engine.think(limits).move;
+    } // end of function move
+
+    //
+    // Play game number game, add it to the tally and its record to records
+    //
+    void play(std::uint64_t game, Tally &tally, std::string *records)
+    {
+        std::uint64_t random = mixSeed(options.seed ^ mixSeed(game));
+        int sideOfA = static_cast<int>(game % 2);
+        std::array<Player, 2> bySide{options.players[sideOfA], options.players[1 - sideOfA]};
+        engine.clear();
+
+        Position<B> position;
+        std::array<int, B::CELLS> moves;
+        int plies = 0;
+        while (!position.gameOver())
+        {
+            int cell = plies < options.opening ? randomMove<B>(position.legalMoves(), random)
+                                               : move(bySide[position.xMoves() ? 0 : 1], position, random);
+            position.make(cell);
+            moves[plies++] = cell;
+        } // end while
+
+        int xState = boardState(position.board(), true);
+        int result = DRAWN;
+        if (xState != static_cast<int>(State::DRAW))
+        {
+            result = (xState == static_cast<int>(State::WIN)) == (sideOfA == 0) ? A_WINS : A_LOSES;
+        } // end if
+        ++tally.results[sideOfA][result];
+        tally.plies += static_cast<std::uint64_t>(plies);
+
+        if (records != nullptr)
+        {
+            *records += std::to_string(game);
+            *records += ' ';
+            *records += PLAYER_NAMES[static_cast<int>(bySide[0])];
+            *records += ' ';
+            *records += PLAYER_NAMES[static_cast<int>(bySide[1])];
+            *records += xState == static_cast<int>(State::WIN) ? " x-wins " : xState == static_cast<int>(State::LOSS) ? " o-wins " : " draw ";
+            for (int index = 0; index < plies; ++index)
+            {
+                *records += std::to_string(moves[index]);
+                *records += index + 1 < plies ? ',' : '\n';
+            } // end for
+
+        } // end if
+    } // end of function play
+};
+
+static void printTally(const Options &options, const Tally &tally, double seconds)
+{
+    const char *nameA = PLAYER_NAMES[static_cast<int>(options.players[0])];
+    const char *nameB = PLAYER_NAMES[static_cast<int>(options.players[1])];
+    std::printf("%s (A) against %s (B), %llu games\n\n", nameA, nameB, static_cast<unsigned long long>(options.games));
+    std::printf("            %12s %12s %12s\n", "A wins", "draws", "B wins");
+    const char *rows[] = {"A as X", "A as O"};
+    Tally total;
+    for (int side = 0; side < 2; ++side)
+    {
+        std::printf("%-10s  %12llu %12llu %12llu\n", rows[side],
+                    static_cast<unsigned long long>(tally.results[side][A_WINS]),
+                    static_cast<unsigned long long>(tally.results[side][DRAWN]),
+                    static_cast<unsigned long long>(tally.results[side][A_LOSES]));
+        for (int result = 0; result < 3; ++result)
+        {
+            total.results[0][result] += tally.results[side][result];
+        } // end for
+
+    } // end for
+    std::printf("%-10s  %12llu %12llu %12llu\n\n", "total",
+                static_cast<unsigned long long>(total.results[0][A_WINS]),
+                static_cast<unsigned long long>(total.results[0][DRAWN]),
+                static_cast<unsigned long long>(total.results[0][A_LOSES]));
+    std::printf("%.2f plies per game, %.2f s, %.0f games/s\n",
+                options.games > 0 ? static_cast<double>(tally.plies) / options.games : 0.0,
+                seconds, seconds > 0.0 ? options.games / seconds : 0.0);
+} // end of function printTally
+
+template <typename B>
+static int run(const Options &options)
+{
+    std::FILE *records = nullptr;
+    if (options.records != nullptr)
+    {
+        records = std::fopen(options.records, "w");
+        if (records == nullptr)
+        {
+            std::perror(options.records);
+            return EXIT_FAILURE;
+        } // end if
+
+    } // end if
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    ThreadPool pool(options.threads);
+    std::size_t workers = pool.threadCount();
+    std::vector<std::unique_ptr<Players<B>>> players;
+    for (std::size_t worker = 0; worker < workers; ++worker)
+    {
+        players.push_back(std::make_unique<Players<B>>(options));
+    } // end for
+
+    //
+    // Worker w plays games w, w + workers, ... of every round, each into
+    // its own tally and record buffer.
+    std::vector<Tally> tallies(workers);
+    std::vector<std::string> buffers(records != nullptr ? workers : 0);
+    std::vector<std::vector<std::size_t>> lineEnds(buffers.size());
+    bool written = true;
+    for (std::uint64_t first = 0; first < options.games; first += ROUND_GAMES)
+    {
+        std::uint64_t last = std::min(options.games, first + ROUND_GAMES);
+        pool.parallelFor(workers, [&](std::size_t worker)
+                         {
+            std::string *buffer = records != nullptr ? &buffers[worker] : nullptr;
+            for (std::uint64_t game = first + worker; game < last; game += workers)
+            {
+                players[worker]->play(game, tallies[worker], buffer);
+                if (buffer != nullptr)
+                {
+                    lineEnds[worker].push_back(buffer->size());
+                } // end if
+            } // end for
+        });
+
+        //
+        // Interleave the buffers back into game order.
+        if (records != nullptr)
+        {
+            std::vector<std::size_t> taken(workers, 0);
+            std::vector<std::size_t> line(workers, 0);
+            for (std::uint64_t game = first; game < last; ++game)
+            {
+                std::size_t worker = (game - first) % workers;
+                std::size_t end = lineEnds[worker][line[worker]++];
+                written = written && std::fwrite(buffers[worker].data() + taken[worker], 1, end - taken[worker], records) ==
+                                         end - taken[worker];
+                taken[worker] = end;
+            } // end for
+
+            for (std::size_t worker = 0; worker < workers; ++worker)
+            {
+                buffers[worker].clear();
+                lineEnds[worker].clear();
+            } // end for
+
+        } // end if
+
+    } // end for
+
+    Tally tally;
+    for (const Tally &part : tallies)
+    {
+        tally.add(part);
+    } // end for
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printTally(options, tally, seconds);
+
+    if (records != nullptr && (std::fclose(records) != 0 || !written))
+    {
+        std::perror(options.records);
+        return EXIT_FAILURE;
+    } // end if
+    return EXIT_SUCCESS;
+} // end of function run
+
+static bool parsePlayer(const char *name, Player &player)
+{
+    for (int index = 0; index < 3; ++index)
+    {
+        if (std::strcmp(name, PLAYER_NAMES[index]) == 0)
+        {
+            player = static_cast<Player>(index);
+            return true;
+        } // end if
+
+    } // end for
+    return false;
+} // end of function parsePlayer
+
+int main(int argc, char **argv)
+{
+    Options options;
+    if (argc < 5 || !parsePlayer(argv[3], options.players[0]) || !parsePlayer(argv[4], options.players[1]))
+    {
+        std::fprintf(stderr,
+                     "usage: %s <3x3|4x4|5x5|7x7> <games> <engine|mcts|random> <engine|mcts|random>\n"
+                     "       [--seed n] [--opening plies] [--depth n] [--playouts n] [--threads n] [--records file]\n",
+                     argv[0]);
+        return EXIT_FAILURE;
+    } // end if
+
+    options.games = std::strtoull(argv[2], nullptr, 10);
+    for (int index = 5; index + 1 < argc; index += 2)
+    {
+        std::string option = argv[index];
+        const char *value = argv[index + 1];
+        if (option == "--seed")
+        {
+            options.seed = std::strtoull(value, nullptr, 10);
+        } // end if
+        else if (option == "--opening")
+        {
+            options.opening = std::atoi(value);
+        } // end else if
+        else if (option == "--depth")
+        {
+            options.depth = std::atoi(value);
+        } // end else if
+        else if (option == "--playouts")
+        {
+            options.playouts = std::strtoull(value, nullptr, 10);
+        } // end else if
+        else if (option == "--threads")
+        {
+            options.threads = static_cast<unsigned>(std::atoi(value));
+        } // end else if
+        else if (option == "--records")
+        {
+            options.records = value;
+        } // end else if
+        else
+        {
+            std::fprintf(stderr, "unknown option %s\n", option.c_str());
+            return EXIT_FAILURE;
+        } // end else
+
+    } // end for
+
+    if ((argc - 5) % 2 != 0)
+    {
+        std::fprintf(stderr, "option %s needs a value\n", argv[argc - 1]);
+        return EXIT_FAILURE;
+    } // end if
+
+    std::string size = argv[1];
+    if (size == "3x3")
+    {
+        return run<Board>(options);
+    } // end if
+    else if (size == "4x4")
+    {
+        return run<Board4x4>(options);
+    } // end else if
+    else if (size == "5x5")
+    {
+        return run<Board5x5>(options);
+    } // end else if
+    else if (size == "7x7")
+    {
+        return run<Board7x7>(options);
+    } // end else if
+
+    std::fprintf(stderr, "unknown board size %s\n", argv[1]);
+    return EXIT_FAILURE;
+} // end of function main
@@ -0,0 +1,94 @@
+//
+// file: tbgen.cpp
+// author: Michael Brockus
+// gmail: <michaelbrockus@gmail.com>
+//
+// USE CASE:
+//
+// Generate an endgame tablebase for the engine, solving every position
+// with at least the given number of marks on all cores:
+//
+//     tbgen <3x3|4x4|5x5|7x7> <output file> [min marks] [--threads <n>]
+//
+// A minimum of 0, the default, solves the whole game, which 3x3 and 4x4
+// can afford: 4x4 is 10165779 positions in 2.5 MB. 5x5 only fits from
+// 20 marks on, 16378864880 positions in 4 GB, and 7x7 not at all, its
+// full boards alone being too many.
+//
+#include "tablebase.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+template <typename B>
+static int generate(const std::string &path, int minMarks, unsigned threads)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    ThreadPool pool(threads);
+    if (!buildTablebase<B>(path, minMarks, pool))
+    {
+        std::fprintf(stderr, "cannot write %s, more than %llu positions or no room\n", path.c_str(),
+                     static_cast<unsigned long long>(MAX_TABLEBASE_POSITIONS));
+        return EXIT_FAILURE;
+    } // end if
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    Tablebase tablebase;
+    if (!tablebase.open(path, B::ROWS, B::COLS, B::IN_A_ROW))
+    {
+        std::fprintf(stderr, "cannot map %s\n", path.c_str());
+        return EXIT_FAILURE;
+    } // end if
+
+    std::printf("%llu positions, %llu bytes, %u threads, %.2f s\n", static_cast<unsigned long long>(tablebase.size()),
+                static_cast<unsigned long long>(sizeof(TablebaseHeader) + (tablebase.size() + 31) / 32 * 8),
+                pool.threadCount(), seconds);
+    return EXIT_SUCCESS;
+} // end of function generate
+
+int main(int argc, char **argv)
+{
+    if (argc < 3)
+    {
+        std::fprintf(stderr, "usage: %s <3x3|4x4|5x5|7x7> <output file> [min marks] [--threads n]\n", argv[0]);
+        return EXIT_FAILURE;
+    } // end if
+
+    int minMarks = 0;
+    unsigned threads = 0;
+    for (int index = 3; index < argc; ++index)
+    {
+        std::string option = argv[index];
+        if (option == "--threads" && index + 1 < argc)
+        {
+            threads = static_cast<unsigned>(std::atoi(argv[++index]));
+        } // end if
+        else
+        {
+            minMarks = std::atoi(argv[index]);
+        } // end else
+
+    } // end for
+
+    std::string size = argv[1];
+    if (size == "3x3")
+    {
+        return generate<Board>(argv[2], minMarks, threads);
+    } // end if
+    else if (size == "4x4")
+    {
+        return generate<Board4x4>(argv[2], minMarks, threads);
+    } // end else if
+    else if (size == "5x5")
+    {
+        return generate<Board5x5>(argv[2], minMarks, threads);
+    } // end else if
+    else if (size == "7x7")
+    {
+        return generate<Board7x7>(argv[2], minMarks, threads);
+    } // end else if
+
+    std::fprintf(stderr, "unknown board size %s\n", argv[1]);
+    return EXIT_FAILURE;
+} // end of function main
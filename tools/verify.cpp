@@ -0,0 +1,407 @@
+//
+// file: verify.cpp
+// author: Michael Brockus
+// gmail: <michaelbrockus@gmail.com>
+//
+// USE CASE:
+//
+// Prove an optimized engine plays like the reference minimax in game.cpp
+// before it is trusted:
+//
+//     verify <3x3|4x4|5x5|7x7> <engine> [options]
+//
+// where the engine is one of
+//
+//     alphabeta    alphaBetaSearch, a table per worker
+//     deepening    iterativeDeepeningSearch, a table per worker
+//     engine       an Engine per worker kept across its positions
+//     parallel     parallelSearch on every core, one position at a time
+//     batch        findBestMoves over every position at once
+//
+// On 3x3 every reachable position is checked. The bigger boards are too
+// big for the reference, so they are sampled: random games stopped with
+// a given number of cells still empty. Options:
+//
+//     --samples <n>      positions sampled on boards above 3x3, default 10000
+//     --empty <n>        empty cells in a sample, default 8
+//     --seed <n>         base of the per-sample seeds, default 1
+//     --threads <n>      worker threads, default one per core
+//     --book <file>      answer from an opening book where it has the board
+//     --tablebase <file> answer from a tablebase where it covers the board
+//
+// A position passes when the engine gives it the same value, won, drawn
+// or lost, as the reference, moves exactly when the game is not over and
+// its move keeps that value. Every failure is printed with the board, one
+// X, O or - per cell in row order, and the exit status is non-zero.
+//
+#include "book.hpp"
+#include "engine.hpp"
+#include "game.hpp"
+#include "tablebase.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+//
+// Slices of the positions handed out per worker thread
+const std::size_t SLICES_PER_THREAD = 16;
+
+//
+// Random games tried for a sample before a finished one is kept
+const int SAMPLE_ATTEMPTS = 64;
+
+//
+// Table of each worker, 1 MB
+const std::size_t WORKER_TABLE_ENTRIES = 1 << 16;
+
+enum class Checked
+{
+    ALPHA_BETA,
+    DEEPENING,
+    ENGINE,
+    PARALLEL,
+    BATCH
+};
+
+const char *const ENGINE_NAMES[] = {"alphabeta", "deepening", "engine", "parallel", "batch"};
+
+struct Options
+{
+    Checked engine = Checked::ALPHA_BETA;
+    std::uint64_t samples = 10000;
+    int empty = 8;
+    std::uint64_t seed = 1;
+    unsigned threads = 0;
+};
+
+//
+// splitmix64, turns a sample number into a well mixed seed
+//
+static std::uint64_t mixSeed(std::uint64_t value)
+{
+    value += 0x9E3779B97F4A7C15ull;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+    return value ^ (value >> 31);
+} // end of function mixSeed
+
+static int sign(int score)
+{
+    return (score > 0) - (score < 0);
+} // end of function sign
+
+template <typename B>
+static std::string boardText(B board)
+{
+    std::string text;
+    for (int cell = 0; cell < B::CELLS; ++cell)
+    {
+        text += board.x & B::cellMask(cell) ? 'X' : board.o & B::cellMask(cell) ? 'O' : '-';
+    } // end for
+    return text;
+} // end of function boardText
+
+//
+// Every position reachable from the empty board, finished games included
+//
+template <typename B>
+static std::vector<B> reachablePositions()
+{
+    std::vector<B> positions;
+    std::vector<B> frontier{B{}};
+    std::unordered_set<std::uint64_t> seen{zobristKey(B{})};
+    while (!frontier.empty())
+    {
+        std::vector<B> next;
+        for (B board : frontier)
+        {
+            positions.push_back(board);
+            bool forX = xToMove(board);
+            if (boardState(board, forX) != static_cast<int>(State::DRAW))
+            {
+                continue;
+            } // end if
+
+            for (typename B::Mask moves = legalMoveMask(board); moves != 0; moves &= moves - 1)
+            {
+                B child = playMove(board, std::countr_zero(moves), forX);
+                if (seen.insert(zobristKey(child)).second)
+                {
+                    next.push_back(child);
+                } // end if
+
+            } // end for
+        } // end for
+        frontier.swap(next);
+    } // end while
+
+    return positions;
+} // end of function reachablePositions
+
+//
+// Random games stopped at empty cells left. Most random games on the
+// bigger boards are won long before that, so a sample is replayed until
+// one gets there, and after SAMPLE_ATTEMPTS tries the finished game is
+// taken instead.
+//
+template <typename B>
+static std::vector<B> sampledPositions(const Options &options)
+{
+    std::vector<B> positions(options.samples);
+    for (std::uint64_t sample = 0; sample < options.samples; ++sample)
+    {
+        std::uint64_t random = mixSeed(options.seed ^ mixSeed(sample));
+        B board;
+        for (int attempt = 0; attempt < SAMPLE_ATTEMPTS; ++attempt)
+        {
+            board = B{};
+            while (std::popcount(legalMoveMask(board)) > options.empty &&
+                   boardState(board, xToMove(board)) == static_cast<int>(State::DRAW))
+            {
+                typename B::Mask moves = legalMoveMask(board);
+                random = mixSeed(random);
+                for (int skip = static_cast<int>(random % static_cast<std::uint64_t>(std::popcount(moves))); skip > 0; --skip)
+                {
+                    moves &= moves - 1;
+                } // end for
+                board = playMove(board, std::countr_zero(moves), xToMove(board));
+            } // end while
+
+            if (boardState(board, xToMove(board)) == static_cast<int>(State::DRAW))
+            {
+                break;
+            } // end if
+
+        } // end for
+        positions[sample] = board;
+    } // end for
+    return positions;
+} // end of function sampledPositions
+
+//
+// Answers of the engine under test for every position
+//
+template <typename B>
+static std::vector<SearchResult> engineResults(const std::vector<B> &positions, Checked engine, ThreadPool &pool)
+{
+    std::vector<SearchResult> results(positions.size());
+    if (engine == Checked::BATCH)
+    {
+        findBestMoves<B>(positions, results, SearchLimits{}, pool);
+        return results;
+    } // end if
+    else if (engine == Checked::PARALLEL)
+    {
+        TranspositionTable table(WORKER_TABLE_ENTRIES);
+        for (std::size_t index = 0; index < positions.size(); ++index)
+        {
+            results[index] = parallelSearch(positions[index], SearchLimits{}, table, pool);
+        } // end for
+        return results;
+    } // end else if
+
+    std::size_t slices = std::max<std::size_t>(1, std::min(positions.size(), pool.threadCount() * SLICES_PER_THREAD));
+    pool.parallelFor(slices, [&](std::size_t slice)
+                     {
+        std::size_t first = positions.size() * slice / slices;
+        std::size_t last = positions.size() * (slice + 1) / slices;
+        if (engine == Checked::ENGINE)
+        {
+            Engine<B> player(WORKER_TABLE_ENTRIES * TABLE_SLOT_BYTES);
+            for (std::size_t index = first; index < last; ++index)
+            {
+                player.setBoard(positions[index]);
+                results[index] = player.think(SearchLimits{});
+            } // end for
+            return;
+        } // end if
+
+        TranspositionTable table(WORKER_TABLE_ENTRIES);
+        for (std::size_t index = first; index < last; ++index)
+        {
+            results[index] = engine == Checked::ALPHA_BETA ? alphaBetaSearch(positions[index], table)
+                                                           : iterativeDeepeningSearch(positions[index], SearchLimits{}, table);
+        } // end for
+    });
+    return results;
+} // end of function engineResults
+
+//
+// What is wrong with the engine's answer, empty when nothing is
+//
+template <typename B>
+static std::string checkResult(B board, const SearchResult &result)
+{
+    SearchResult reference = minimaxSearch(board);
+    std::string problem;
+    if (sign(result.score) != sign(reference.score))
+    {
+        problem = "wrong value";
+    } // end if
+    else if ((reference.move == NO_MOVE) != (result.move == NO_MOVE))
+    {
+        problem = reference.move == NO_MOVE ? "move after the game is over" : "no move";
+    } // end else if
+    else if (result.move != NO_MOVE && (result.move < 0 || result.move >= B::CELLS ||
+                                        (legalMoveMask(board) & B::cellMask(result.move)) == 0))
+    {
+        problem = "illegal move";
+    } // end else if
+    else if (result.move != NO_MOVE &&
+             sign(scoreBeforeMove(minimaxSearch(playMove(board, result.move, xToMove(board))).score)) != sign(reference.score))
+    {
+        problem = "move gives the value away";
+    } // end else if
+
+    if (problem.empty())
+    {
+        return problem;
+    } // end if
+    return boardText(board) + " " + problem + ": engine move " + std::to_string(result.move) + " score " +
+           std::to_string(result.score) + ", reference move " + std::to_string(reference.move) + " score " +
+           std::to_string(reference.score) + "\n";
+} // end of function checkResult
+
+template <typename B>
+static int run(const Options &options)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    ThreadPool pool(options.threads);
+    std::vector<B> positions = std::is_same_v<B, Board> ? reachablePositions<B>() : sampledPositions<B>(options);
+    std::vector<SearchResult> results = engineResults(positions, options.engine, pool);
+
+    std::size_t slices = std::max<std::size_t>(1, std::min(positions.size(), pool.threadCount() * SLICES_PER_THREAD));
+    std::vector<std::string> failures(slices);
+    std::vector<std::uint64_t> failureCounts(slices);
+    pool.parallelFor(slices, [&](std::size_t slice)
+                     {
+        std::size_t first = positions.size() * slice / slices;
+        std::size_t last = positions.size() * (slice + 1) / slices;
+        for (std::size_t index = first; index < last; ++index)
+        {
+            std::string failure = checkResult(positions[index], results[index]);
+            if (!failure.empty())
+            {
+                failures[slice] += failure;
+                ++failureCounts[slice];
+            } // end if
+        } // end for
+    });
+
+    std::uint64_t failed = 0;
+    for (std::size_t slice = 0; slice < slices; ++slice)
+    {
+        std::fputs(failures[slice].c_str(), stdout);
+        failed += failureCounts[slice];
+    } // end for
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("%s: %zu positions, %llu failed, %u threads, %.2f s\n", ENGINE_NAMES[static_cast<int>(options.engine)],
+                positions.size(), static_cast<unsigned long long>(failed), pool.threadCount(), seconds);
+    return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+} // end of function run
+
+static bool parseEngine(const char *name, Checked &engine)
+{
+    for (int index = 0; index < 5; ++index)
+    {
+        if (std::strcmp(name, ENGINE_NAMES[index]) == 0)
+        {
+            engine = static_cast<Checked>(index);
+            return true;
+        } // end if
+
+    } // end for
+    return false;
+} // end of function parseEngine
+
+int main(int argc, char **argv)
+{
+    Options options;
+    if (argc < 3 || !parseEngine(argv[2], options.engine))
+    {
+        std::fprintf(stderr,
+                     "usage: %s <3x3|4x4|5x5|7x7> <alphabeta|deepening|engine|parallel|batch>\n"
+                     "       [--samples n] [--empty n] [--seed n] [--threads n] [--book file] [--tablebase file]\n",
+                     argv[0]);
+        return EXIT_FAILURE;
+    } // end if
+
+    for (int index = 3; index + 1 < argc; index += 2)
+    {
+        std::string option = argv[index];
+        const char *value = argv[index + 1];
+        if (option == "--samples")
+        {
+            options.samples = std::strtoull(value, nullptr, 10);
+        } // end if
+        else if (option == "--empty")
+        {
+            options.empty = std::atoi(value);
+        } // end else if
+        else if (option == "--seed")
+        {
+            options.seed = std::strtoull(value, nullptr, 10);
+        } // end else if
+        else if (option == "--threads")
+        {
+            options.threads = static_cast<unsigned>(std::atoi(value));
+        } // end else if
+        else if (option == "--book")
+        {
+            if (!loadOpeningBook(value))
+            {
+                std::fprintf(stderr, "cannot open book %s\n", value);
+                return EXIT_FAILURE;
+            } // end if
+
+        } // end else if
+        else if (option == "--tablebase")
+        {
+            if (!loadTablebase(value))
+            {
+                std::fprintf(stderr, "cannot open tablebase %s\n", value);
+                return EXIT_FAILURE;
+            } // end if
+
+        } // end else if
+        else
+        {
+            std::fprintf(stderr, "unknown option %s\n", option.c_str());
+            return EXIT_FAILURE;
+        } // end else
+
+    } // end for
+
+    if ((argc - 3) % 2 != 0)
+    {
+        std::fprintf(stderr, "option %s needs a value\n", argv[argc - 1]);
+        return EXIT_FAILURE;
+    } // end if
+
+    std::string size = argv[1];
+    if (size == "3x3")
+    {
+        return run<Board>(options);
+    } // end if
+    else if (size == "4x4")
+    {
+        return run<Board4x4>(options);
+    } // end else if
+    else if (size == "5x5")
+    {
+        return run<Board5x5>(options);
+    } // end else if
+    else if (size == "7x7")
+    {
+        return run<Board7x7>(options);
+    } // end else if
+
+    std::fprintf(stderr, "unknown board size %s\n", argv[1]);
+    return EXIT_FAILURE;
+} // end of function main